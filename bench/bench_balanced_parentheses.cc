@@ -0,0 +1,110 @@
+// Tree navigation with BalancedParentheses on random trees with millions of nodes,
+// against a parenthesis-by-parenthesis scan with BitVector::At as done by hand before.
+//
+// $ bench_balanced_parentheses 22
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "balanced_parentheses.h"
+#include "bit_vector.h"
+
+using namespace succinct_bv;
+
+static std::vector<bool> RandomTree(uint64_t n_nodes, std::mt19937_64 &rng) {
+    std::vector<bool> v;
+    v.reserve(2 * n_nodes);
+    uint64_t opens = 0;
+    uint64_t depth = 0;
+
+    while (v.size() < 2 * n_nodes) {
+        bool open = opens < n_nodes
+                    && (depth == 0 || rng() % (2 * n_nodes - v.size()) < n_nodes - opens);
+        v.push_back(open);
+
+        if (open) {
+            ++opens;
+            ++depth;
+        } else {
+            --depth;
+        }
+    }
+
+    return v;
+}
+
+static double NsPerQuery(const std::vector<uint64_t> &args,
+                         const std::function<uint64_t(uint64_t)> &query) {
+    uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (auto x : args)
+        sum += query(x);
+
+    double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+
+    // keep the queries from being optimized away.
+    if (sum == 1) std::cout << "";
+    return ns / args.size();
+}
+
+int main(int argc, char **argv) {
+    uint64_t n_nodes = uint64_t(1) << (argc > 1 ? std::atoi(argv[1]) : 22);
+    std::mt19937_64 rng(0);
+    std::vector<bool> v = RandomTree(n_nodes, rng);
+
+    auto start = std::chrono::steady_clock::now();
+    BalancedParentheses bp(v);
+    double build_s = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    const BitVector &bv = bp.bit_vector();
+
+    std::vector<uint64_t> opens;
+    std::vector<uint64_t> closes;
+
+    while (opens.size() < (1 << 20)) {
+        uint64_t x = rng() % v.size();
+        (v[x] ? opens : closes).push_back(x);
+    }
+
+    closes.resize(std::min(closes.size(), opens.size()));
+
+    // sampled nodes for the O(subtree) and O(distance) scans.
+    std::vector<uint64_t> few(opens.begin(), opens.begin() + 4096);
+
+    std::cout << "nodes=" << n_nodes << " bytes/node=" << static_cast<double>(bp.n_bytes()) / n_nodes
+              << " rmM-tree overhead bits/parenthesis="
+              << 8.0 * (bp.n_bytes() - bv.n_bytes()) / v.size()
+              << " build_s=" << build_s << std::endl;
+    std::cout << "  FindClose   " << NsPerQuery(opens, [&](uint64_t i) { return bp.FindClose(i); })
+              << " ns" << std::endl;
+    std::cout << "  FindOpen    " << NsPerQuery(closes, [&](uint64_t i) { return bp.FindOpen(i); })
+              << " ns" << std::endl;
+    std::cout << "  Enclose     " << NsPerQuery(opens, [&](uint64_t i) { return bp.Enclose(i); })
+              << " ns" << std::endl;
+    std::cout << "  FirstChild  " << NsPerQuery(opens, [&](uint64_t i) { return bp.FirstChild(i); })
+              << " ns" << std::endl;
+    std::cout << "  NextSibling " << NsPerQuery(opens, [&](uint64_t i) { return bp.NextSibling(i); })
+              << " ns" << std::endl;
+    std::cout << "  SubtreeSize " << NsPerQuery(opens, [&](uint64_t i) { return bp.SubtreeSize(i); })
+              << " ns" << std::endl;
+    std::cout << "  Depth       " << NsPerQuery(opens, [&](uint64_t i) { return bp.Depth(i); })
+              << " ns" << std::endl;
+
+    std::cout << "  scan FindClose " << NsPerQuery(few, [&](uint64_t i) {
+        int64_t excess = 1;
+        while (excess > 0) excess += bv.At(++i) ? 1 : -1;
+        return i;
+    }) << " ns" << std::endl;
+    std::cout << "  scan Enclose   " << NsPerQuery(few, [&](uint64_t i) {
+        int64_t excess = 0;
+        while (i > 0 && excess > -1) excess += bv.At(--i) ? -1 : 1;
+        return i;
+    }) << " ns" << std::endl;
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Reports peak RSS of building a BitVector from a std::vector<bool> or from a word stream.
+// Each mode runs in its own process because the peak RSS cannot be reset.
+//
+// $ bench_build_memory vector 30
+// $ bench_build_memory stream 30
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "bit_vector.h"
+#include "bit_vector_builder.h"
+
+using namespace succinct_bv;
+
+static size_t PeakRssBytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
+
+static BitVector BuildFromStream(uint64_t n) {
+    std::mt19937 rng(0);
+    uint64_t n_words = n / 32;
+
+    return BitVectorBuilder::FromCallback([&](uint32_t *words, size_t n_max) {
+        size_t k = 0;
+
+        for (; k < n_max && n_words > 0; ++k, --n_words)
+            words[k] = rng();
+
+        return k;
+    }, n);
+}
+
+static BitVector BuildFromVector(uint64_t n) {
+    std::mt19937 rng(0);
+    std::vector<bool> v(n);
+
+    for (uint64_t i = 0; i < n; i += 32) {
+        uint32_t word = rng();
+
+        for (int j = 0; j < 32; ++j)
+            v[i + j] = (word >> (31 - j)) & 1;
+    }
+
+    return BitVector(v);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " vector|stream log2_n_bits" << std::endl;
+        return 1;
+    }
+
+    bool stream = std::strcmp(argv[1], "stream") == 0;
+    uint64_t n = uint64_t(1) << std::atoi(argv[2]);
+    auto start = std::chrono::steady_clock::now();
+    BitVector bv = stream ? BuildFromStream(n) : BuildFromVector(n);
+
+    double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+
+    std::cout << argv[1] << " n=2^" << argv[2]
+              << " n_bytes=" << bv.n_bytes()
+              << " peak_rss=" << PeakRssBytes()
+              << " ratio=" << static_cast<double>(PeakRssBytes()) / bv.n_bytes()
+              << " build_s=" << seconds << std::endl;
+    return 0;
+}
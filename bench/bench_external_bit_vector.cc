@@ -0,0 +1,95 @@
+// Random At, Rank and Select queries on an ExternalBitVector stored in a local file.
+// The file is dropped from the OS page cache before each query type,
+// so misses of the LRU cache are served from the disk.
+//
+// $ bench_external_bit_vector /tmp/bits.bin 30 64
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "external_bit_vector.h"
+
+using namespace succinct_bv;
+
+static void DropPageCache(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+static void WriteRandomFile(const std::string &path, uint64_t n) {
+    std::mt19937 rng(0);
+    std::vector<uint32_t> words(1 << 16);
+    FILE *file = fopen(path.c_str(), "wb");
+
+    for (uint64_t w = 0; w < n / 32; w += words.size()) {
+        for (auto &word : words)
+            word = rng();
+
+        fwrite(words.data(), sizeof(uint32_t), words.size(), file);
+    }
+
+    fclose(file);
+}
+
+template<class F>
+static void Run(const char *name, const std::string &path, ExternalBitVector &ebv,
+                const std::vector<uint64_t> &args, F query) {
+    DropPageCache(path);
+    ebv.ResetCounters();
+    uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (auto x : args)
+        sum += query(x);
+
+    double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / args.size();
+
+    std::cout << name << " ns/query=" << ns << " hits=" << ebv.hits()
+              << " misses=" << ebv.misses() << " checksum=" << sum << std::endl;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        std::cerr << "usage: " << argv[0] << " path log2_n_bits cache_mb [page_size]" << std::endl;
+        return 1;
+    }
+
+    std::string path = argv[1];
+    uint64_t n = uint64_t(1) << std::atoi(argv[2]);
+    size_t cache_bytes = static_cast<size_t>(std::atoi(argv[3])) << 20;
+    size_t page_size = argc > 4 ? std::atoi(argv[4]) : 4096;
+
+    WriteRandomFile(path, n);
+    ExternalBitVector ebv(path, n, page_size, cache_bytes);
+    uint64_t n_ones = ebv.Rank(n - 1);
+
+    std::mt19937_64 rng(1);
+    std::vector<uint64_t> positions(1 << 20);
+    std::vector<uint64_t> ranks(1 << 20);
+
+    for (size_t k = 0; k < positions.size(); ++k) {
+        positions[k] = rng() % n;
+        ranks[k] = rng() % n_ones;
+    }
+
+    std::cout << "n=2^" << argv[2] << " page_size=" << page_size << " cache_mb=" << argv[3]
+              << " directory_bytes=" << ebv.n_bytes() << std::endl;
+
+    Run("At", path, ebv, positions, [&](uint64_t x) { return ebv.At(x); });
+    Run("Rank", path, ebv, positions, [&](uint64_t x) { return ebv.Rank(x); });
+    Run("Select", path, ebv, ranks, [&](uint64_t i) { return ebv.Select(i); });
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Space and query latency of HybridBitVector against BitVector on the generators of the tests,
+// and on a vector mixing dense, sparse and long runs.
+//
+// $ bench_hybrid_bit_vector 24
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bit_vector.h"
+#include "hybrid_bit_vector.h"
+
+using namespace succinct_bv;
+
+static std::vector<bool> Generate(const std::string &name, uint64_t n, std::mt19937_64 &rng) {
+    std::vector<bool> v(n, false);
+    bool sparse_mode = true;
+    bool run = false;
+    uint64_t run_end = 0;
+
+    for (uint64_t i = 0; i < n; ++i) {
+        if (name == "dense") {
+            v[i] = rng() % 2 == 0;
+        } else if (name == "sparse") {
+            v[i] = rng() % 1000 == 0;
+        } else if (name == "mix") {
+            // alternates every 10000 bits as v5_ in the tests.
+            if (i % 10000 == 0) sparse_mode = !sparse_mode;
+            v[i] = sparse_mode ? rng() % 1000 == 0 : rng() % 2 == 0;
+        } else {
+            // runs of random length up to 2^18 bits, one in four is dense or sparse.
+            if (i == run_end) {
+                run_end = std::min(n, i + 1 + rng() % (1 << 18));
+                run = !run;
+                sparse_mode = rng() % 4 == 0;
+            }
+
+            if (sparse_mode)
+                v[i] = run ? rng() % 2 == 0 : rng() % 1000 == 0;
+            else
+                v[i] = run;
+        }
+    }
+
+    return v;
+}
+
+static double NsPerQuery(const std::vector<uint64_t> &args,
+                         const std::function<uint64_t(uint64_t)> &query) {
+    uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (auto x : args)
+        sum += query(x);
+
+    double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+
+    // keep the queries from being optimized away.
+    if (sum == 1) std::cout << "";
+    return ns / args.size();
+}
+
+int main(int argc, char **argv) {
+    uint64_t n = uint64_t(1) << (argc > 1 ? std::atoi(argv[1]) : 24);
+    std::mt19937_64 rng(0);
+
+    for (std::string name : {"dense", "sparse", "mix", "runs"}) {
+        std::vector<bool> v = Generate(name, n, rng);
+        BitVector bv(v);
+        HybridBitVector hbv(v);
+        uint64_t n_ones = bv.Rank(n - 1);
+        std::vector<uint64_t> positions(1 << 20);
+        std::vector<uint64_t> ranks(1 << 20);
+
+        for (size_t k = 0; k < positions.size(); ++k) {
+            positions[k] = rng() % n;
+            ranks[k] = n_ones == 0 ? 0 : rng() % n_ones;
+        }
+
+        std::cout << name << " n=" << n << " ones=" << n_ones
+                  << " containers(array/bitmap/run)=" << hbv.n_arrays() << "/"
+                  << hbv.n_bitmaps() << "/" << hbv.n_runs() << std::endl;
+        std::cout << "  BitVector       bits/bit=" << 8.0 * bv.n_bytes() / n
+                  << " At=" << NsPerQuery(positions, [&](uint64_t x) { return bv.At(x); })
+                  << " Rank=" << NsPerQuery(positions, [&](uint64_t x) { return bv.Rank(x); })
+                  << " Select=" << NsPerQuery(ranks, [&](uint64_t i) { return bv.Select(i); })
+                  << std::endl;
+        std::cout << "  HybridBitVector bits/bit=" << 8.0 * hbv.n_bytes() / n
+                  << " At=" << NsPerQuery(positions, [&](uint64_t x) { return hbv.At(x); })
+                  << " Rank=" << NsPerQuery(positions, [&](uint64_t x) { return hbv.Rank(x); })
+                  << " Select=" << NsPerQuery(ranks, [&](uint64_t i) { return hbv.Select(i); })
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Space and Rank latency of PackedSymbolVector<2> on a random DNA sequence,
+// against one BitVector per nucleotide as stored by the genomics pipeline.
+//
+// $ bench_packed_symbol_vector 28
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "bit_vector.h"
+#include "packed_symbol_vector.h"
+
+using namespace succinct_bv;
+
+static double NsPerQuery(const std::vector<uint64_t> &args,
+                         const std::function<uint64_t(uint64_t)> &query) {
+    uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (auto x : args)
+        sum += query(x);
+
+    double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+
+    // keep the queries from being optimized away.
+    if (sum == 1) std::cout << "";
+    return ns / args.size();
+}
+
+int main(int argc, char **argv) {
+    uint64_t n = uint64_t(1) << (argc > 1 ? std::atoi(argv[1]) : 24);
+    std::mt19937_64 rng(0);
+    std::vector<uint8_t> v(n);
+
+    for (auto &c : v)
+        c = rng() % 4;
+
+    PackedSymbolVector<2> sv(v);
+    std::array<BitVector, 4> bvs;
+    size_t bvs_bytes = 0;
+
+    for (uint8_t c = 0; c < 4; ++c) {
+        std::vector<bool> bits(n);
+
+        for (uint64_t x = 0; x < n; ++x)
+            bits[x] = v[x] == c;
+
+        bvs[c] = BitVector(bits);
+        bvs_bytes += bvs[c].n_bytes();
+    }
+
+    std::vector<uint64_t> positions(1 << 22);
+
+    for (auto &x : positions)
+        x = rng() % n;
+
+    std::cout << "n=" << n << std::endl;
+    std::cout << "  4 BitVectors        bits/symbol=" << 8.0 * bvs_bytes / n
+              << " Rank=" << NsPerQuery(positions, [&](uint64_t x) { return bvs[x % 4].Rank(x); })
+              << " RankAll=" << NsPerQuery(positions, [&](uint64_t x) {
+                  return bvs[0].Rank(x) + bvs[1].Rank(x) + bvs[2].Rank(x) + bvs[3].Rank(x);
+              }) << std::endl;
+    std::cout << "  PackedSymbolVector  bits/symbol=" << 8.0 * sv.n_bytes() / n
+              << " Rank=" << NsPerQuery(positions, [&](uint64_t x) { return sv.Rank(x % 4, x); })
+              << " RankAll=" << NsPerQuery(positions, [&](uint64_t x) {
+                  auto r = sv.RankAll(x);
+                  return r[0] + r[1] + r[2] + r[3];
+              }) << std::endl;
+
+    return 0;
+}
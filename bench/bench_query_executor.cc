@@ -0,0 +1,78 @@
+// Throughput of QueryExecutor against answering the same random batch in input order,
+// for an increasing number of workers, on a vector too large for the caches.
+//
+// $ bench_query_executor 31 8
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "bit_vector.h"
+#include "bit_vector_builder.h"
+#include "query_executor.h"
+
+using namespace succinct_bv;
+
+static double QueriesPerSecond(size_t n_queries, const std::function<uint64_t()> &run) {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t sum = run();
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // keep the queries from being optimized away.
+    if (sum == 1) std::cout << "";
+    return n_queries / s;
+}
+
+int main(int argc, char **argv) {
+    uint64_t n = uint64_t(1) << (argc > 1 ? std::atoi(argv[1]) : 28);
+    size_t max_threads = argc > 2 ? std::atoi(argv[2]) : std::thread::hardware_concurrency();
+    std::mt19937_64 rng(0);
+
+    uint64_t n_words = n / 32;
+    BitVector bv = BitVectorBuilder::FromCallback([&](uint32_t *words, size_t max_words) {
+        size_t filled = std::min<uint64_t>(max_words, n_words);
+
+        for (size_t k = 0; k < filled; ++k)
+            words[k] = uint32_t(rng());
+
+        n_words -= filled;
+        return filled;
+    }, n);
+    uint64_t n_ones = bv.Rank(n - 1);
+
+    std::vector<QueryExecutor::Query> queries(1 << 22);
+
+    for (auto &q : queries) {
+        q.type = static_cast<QueryExecutor::Query::Type>(rng() % 3);
+        q.x = q.type == QueryExecutor::Query::kSelect ? rng() % n_ones : rng() % n;
+    }
+
+    std::cout << "n=" << n << " queries=" << queries.size() << std::endl;
+    std::cout << "  input order  q/s=" << QueriesPerSecond(queries.size(), [&]() {
+        uint64_t sum = 0;
+
+        for (auto &q : queries) {
+            switch (q.type) {
+                case QueryExecutor::Query::kAt: sum += bv.At(q.x); break;
+                case QueryExecutor::Query::kRank: sum += bv.Rank(q.x); break;
+                default: sum += bv.Select(q.x);
+            }
+        }
+
+        return sum;
+    }) << std::endl;
+
+    for (size_t n_threads = 1; n_threads <= std::max<size_t>(1, max_threads); n_threads *= 2) {
+        QueryExecutor executor(n_threads);
+        std::cout << "  threads=" << n_threads << " q/s=" << QueriesPerSecond(queries.size(), [&]() {
+            std::vector<uint64_t> answers = executor.Execute(bv, queries);
+            return answers.front() + answers.back();
+        }) << std::endl;
+    }
+
+    return 0;
+}
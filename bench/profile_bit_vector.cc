@@ -0,0 +1,189 @@
+// Hardware counters per query of BitVector::At, Rank and Select, for vectors that fit in
+// L1/L2, in the last level cache and in DRAM, with dense and sparse ones.
+// Counters are read with perf_event_open and shown as n/a when the kernel or the CPU
+// does not provide them (e.g. perf_event_paranoid > 2, or in a container or a VM).
+//
+// $ profile_bit_vector 28
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bit_vector.h"
+#include "bit_vector_builder.h"
+
+using namespace succinct_bv;
+
+class Counters {
+public:
+    static constexpr int kN = 5;
+
+    Counters() {
+        const std::pair<uint32_t, uint64_t> events[kN] = {
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                     | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+                {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                     | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}};
+
+        for (int k = 0; k < kN; ++k) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[k].first;
+            attr.config = events[k].second;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds_[k] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+    }
+
+    ~Counters() {
+        for (int fd : fds_)
+            if (fd >= 0) close(fd);
+    }
+
+    void Start() {
+        for (int fd : fds_) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    // counts since Start, scaled when the counters were multiplexed. -1 if not available.
+    std::vector<double> Stop() {
+        std::vector<double> counts(kN, -1);
+
+        for (int k = 0; k < kN; ++k) {
+            if (fds_[k] < 0) continue;
+            ioctl(fds_[k], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t values[3];
+
+            if (read(fds_[k], values, sizeof(values)) != sizeof(values) || values[2] == 0) continue;
+            counts[k] = double(values[0]) * values[1] / values[2];
+        }
+
+        return counts;
+    }
+
+    bool any() const {
+        return std::any_of(fds_, fds_ + kN, [](int fd) { return fd >= 0; });
+    }
+
+private:
+    int fds_[kN];
+};
+
+static BitVector Generate(uint64_t n, bool dense, std::mt19937_64 &rng) {
+    uint64_t n_words = n / 32;
+
+    return BitVectorBuilder::FromCallback([&](uint32_t *words, size_t max_words) {
+        size_t filled = std::min<uint64_t>(max_words, n_words);
+
+        // sparse vectors have one one in 1024 bits on average.
+        for (size_t k = 0; k < filled; ++k)
+            words[k] = dense ? uint32_t(rng()) : rng() % 32 == 0 ? 1u << (rng() % 32) : 0;
+
+        n_words -= filled;
+        return filled;
+    }, n);
+}
+
+// the query is a template argument so that no indirect call is counted with it.
+template<class F>
+static void Profile(Counters &counters, const std::string &name, const std::vector<uint64_t> &args,
+                    F query) {
+    uint64_t sum = 0;
+
+    // warm up the caches and the branch predictors as a steady state would.
+    for (size_t k = 0; k < args.size() / 8; ++k)
+        sum += query(args[k]);
+
+    counters.Start();
+    auto start = std::chrono::steady_clock::now();
+
+    for (auto x : args)
+        sum += query(x);
+
+    double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+    std::vector<double> counts = counters.Stop();
+
+    // keep the queries from being optimized away.
+    if (sum == 1) std::cout << "";
+
+    std::cout << "  " << std::left << std::setw(7) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(9) << ns / args.size();
+
+    for (int k = 0; k < Counters::kN; ++k) {
+        if (counts[k] < 0)
+            std::cout << std::setw(9) << "n/a";
+        else
+            std::cout << std::setw(9) << counts[k] / args.size();
+    }
+
+    if (counts[0] > 0 && counts[1] >= 0)
+        std::cout << std::setw(7) << std::setprecision(2) << counts[1] / counts[0];
+    else
+        std::cout << std::setw(7) << "n/a";
+
+    std::cout << std::endl;
+}
+
+int main(int argc, char **argv) {
+    int max_log_n = argc > 1 ? std::atoi(argv[1]) : 28;
+    std::mt19937_64 rng(0);
+    Counters counters;
+
+    if (!counters.any())
+        std::cout << "hardware counters are not available, only ns/query is measured." << std::endl;
+
+    // fits in L1/L2, fits in the last level cache, needs DRAM.
+    for (int log_n : {16, 22, max_log_n}) {
+        if (log_n > max_log_n) continue;
+
+        for (bool dense : {true, false}) {
+            uint64_t n = uint64_t(1) << log_n;
+            BitVector bv = Generate(n, dense, rng);
+            uint64_t n_ones = bv.Rank(n - 1);
+            std::vector<uint64_t> positions(1 << 22);
+            std::vector<uint64_t> ranks(1 << 22);
+
+            for (size_t k = 0; k < positions.size(); ++k) {
+                positions[k] = rng() % n;
+                ranks[k] = n_ones == 0 ? 0 : rng() % n_ones;
+            }
+
+            std::cout << "n=2^" << log_n << (dense ? " dense" : " sparse") << " ones=" << n_ones
+                      << " bits/bit=" << std::setprecision(3) << 8.0 * bv.n_bytes() / n << std::endl;
+            std::cout << "  " << std::left << std::setw(7) << "query" << std::right;
+
+            for (std::string column : {"ns/q", "cycles/q", "instr/q", "LLC/q", "dTLB/q", "brmis/q"})
+                std::cout << std::setw(9) << column;
+
+            std::cout << std::setw(7) << "IPC" << std::endl;
+            Profile(counters, "At", positions, [&](uint64_t x) { return bv.At(x); });
+            Profile(counters, "Rank", positions, [&](uint64_t x) { return bv.Rank(x); });
+            Profile(counters, "Select", ranks, [&](uint64_t i) { return bv.Select(i); });
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+#ifndef BALANCED_PARENTHESES_H_
+#define BALANCED_PARENTHESES_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <deque>
+#include <vector>
+
+#include "bit_vector.h"
+
+namespace succinct_bv {
+    /**
+     Navigation of an ordinal tree encoded as balanced parentheses, 1 for '(' and 0 for ')'.
+     A node is identified by the position of its open parenthesis.
+     A range min-max tree stores the minimum excess of every block of kBlockBits bits
+     and of every subtree of blocks, so searches climb and descend it in O(log n)
+     and scan at most two blocks with byte tables.
+     Excess is computed with BitVector::Rank.
+     */
+    class BalancedParentheses {
+    public:
+        static constexpr uint64_t npos = UINT64_MAX;
+
+        static constexpr uint64_t kBlockBits = 1024;
+
+        BalancedParentheses() {};
+
+        BalancedParentheses(const std::deque<bool> &v) : bv_(v) { Init(); }
+
+        BalancedParentheses(const std::vector<bool> &v) : bv_(v) { Init(); }
+
+        explicit BalancedParentheses(const BitVector &bv) : bv_(bv) { Init(); }
+
+        // #'(' - #')' in [0..i].
+        int64_t Excess(uint64_t i) const {
+            return 2 * static_cast<int64_t>(bv_.Rank(i)) - static_cast<int64_t>(i) - 1;
+        }
+
+        // position of ')' matching '(' at i.
+        uint64_t FindClose(uint64_t i) const;
+
+        // position of '(' matching ')' at i.
+        uint64_t FindOpen(uint64_t i) const;
+
+        // '(' of the closest pair enclosing '(' at i, or npos for the root.
+        uint64_t Enclose(uint64_t i) const;
+
+        uint64_t Parent(uint64_t i) const { return Enclose(i); }
+
+        // npos for a leaf.
+        uint64_t FirstChild(uint64_t i) const {
+            return i + 1 < n_ && At(i + 1) ? i + 1 : npos;
+        }
+
+        // npos for the last child.
+        uint64_t NextSibling(uint64_t i) const {
+            uint64_t j = FindClose(i) + 1;
+            return j < n_ && At(j) ? j : npos;
+        }
+
+        // number of nodes in the subtree, including i.
+        uint64_t SubtreeSize(uint64_t i) const { return (FindClose(i) - i + 1) / 2; }
+
+        // the root has depth 0.
+        uint64_t Depth(uint64_t i) const { return static_cast<uint64_t>(Excess(i)) - 1; }
+
+        const BitVector &bit_vector() const { return bv_; }
+
+        // number of parentheses.
+        uint64_t size() const { return n_; }
+
+        size_t n_bytes() const {
+            return bv_.n_bytes() + leaf_mins_.capacity() * sizeof(int16_t)
+                   + mins_.capacity() * sizeof(int64_t);
+        }
+
+    private:
+        void Init();
+
+        bool At(uint64_t x) const {
+            return (bv_.p_->b_[x / 32] >> (31 - x % 32)) & 1u;
+        }
+
+        uint8_t Byte(uint64_t x) const {
+            return static_cast<uint8_t>(bv_.p_->b_[x / 32] >> (24 - x % 32));
+        }
+
+        // excess before the b-th block.
+        int64_t BlockBase(uint64_t b) const {
+            return b == 0 ? 0 : Excess(b * kBlockBits - 1);
+        }
+
+        // minimum excess in the subtree rooted at node u of the range min-max tree.
+        int64_t Min(uint64_t u) const;
+
+        // smallest j > i with Excess(j) <= t, or npos.
+        uint64_t FwdSearch(uint64_t i, int64_t t) const;
+
+        // largest k < i with Excess(k) <= t, plus one, or npos. Excess(-1) is 0.
+        uint64_t BwdSearch(uint64_t i, int64_t t) const;
+
+        // smallest j in [from, the end of its block] with Excess(j) <= t, or npos.
+        uint64_t ScanForward(uint64_t from, int64_t excess, int64_t t) const;
+
+        // largest k in [the start of its block, from] with Excess(k) <= t, or npos.
+        uint64_t ScanBackward(uint64_t from, int64_t excess, int64_t t) const;
+
+        class ExcessTable {
+        public:
+            ExcessTable();
+            // #'(' - #')' in a byte, the first parenthesis in the most significant bit.
+            int8_t excess_[256];
+            // minimum excess of a non-empty prefix of a byte.
+            int8_t min_[256];
+        };
+
+        BitVector bv_;
+        uint64_t n_ = 0;
+        uint64_t n_blocks_ = 0;
+        // number of leaves of the range min-max tree, a power of two.
+        uint64_t n_leaves_ = 0;
+        // minimum excess in each block relative to BlockBase.
+        std::vector<int16_t> leaf_mins_;
+        // minimum excess of inner node u at u, in heap order from 1.
+        std::vector<int64_t> mins_;
+        static inline ExcessTable excessTable = ExcessTable();
+    };
+}
+
+#endif // BALANCED_PARENTHESES_H_
@@ -16,45 +16,52 @@
 
 namespace succinct_bv {
     class BitVector;
+    class BitVectorBuilder;
+    class BalancedParentheses;
 }
 void swap(succinct_bv::BitVector& a, succinct_bv::BitVector&);
 
 namespace succinct_bv {
     class BitVector {
     public:
-        BitVector() : b_(nullptr) {};
+        BitVector() {};
 
+        // copies share the immutable payload, so copying is O(1).
         BitVector(const BitVector& copy);
 
         BitVector(BitVector&& copy);
 
-        BitVector(const std::deque<bool> &v) : b_(nullptr) { Init(v); }
+        BitVector(const std::deque<bool> &v) { Init(v); }
 
-        BitVector(const std::vector<bool> &v) : b_(nullptr) { Init(v); }
+        BitVector(const std::vector<bool> &v) { Init(v); }
 
-        ~BitVector() {
-#ifdef _MSC_VER
-            if(this->b_ != nullptr) _aligned_free(b_);
-#else
-            if(this->b_ != nullptr) free(b_);
-#endif
-        }
+        ~BitVector() {}
 
         bool At(uint64_t x) const;
 
         uint64_t Rank(uint64_t x) const;
 
         uint64_t Select(uint64_t i) const {
-            if (b_ == nullptr) throw std::runtime_error("Bitvector is empty.");
-            if(s_.empty()) return 32;
-            return s_[i / (64 * 64)]->Select(this, i % (64 * 64));
+            if (p_ == nullptr) throw std::runtime_error("Bitvector is empty.");
+            if(p_->s_.empty()) return 32;
+            return p_->s_[i / (64 * 64)]->Select(p_.get(), i % (64 * 64));
         }
 
+        // position of the i-th one in a small block whose first bit is the most significant.
+        static uint8_t SelectOn32bits(uint32_t bits, uint8_t i);
+
+        // number of bits.
+        uint64_t size() const { return p_ == nullptr ? 0 : p_->n_; }
+
         size_t n_bytes() const;
 
         friend void ::swap(BitVector& a, BitVector& b);
 
-        BitVector& operator=(BitVector bv);
+        friend class BitVectorBuilder;
+
+        friend class BalancedParentheses;
+
+        BitVector& operator=(const BitVector& bv);
 
         //BitVector& operator=(BitVector& bv);
 
@@ -69,44 +76,30 @@ namespace succinct_bv {
         BitVector& operator=(std::deque<bool>&& bv);
 
     private:
+        class Payload;
 
-        template<class T> void Init(const T &v) {
-            if (v.empty()) {
-                throw std::runtime_error("Given container is empty.");
-            }
-
-            InitVector(v);
-            InitRankIndex();
-            InitSelectIndex();
-        }
-
-        template<class T> void InitVector(const T &v);
-
-        void InitRankIndex();
-
-        void InitSelectIndex();
+        // builds a new payload so that copies sharing the old one are not affected.
+        template<class T> void Init(const T &v);
 
         //void InitSelectTable();
 
-        uint8_t SelectOn32bits(uint32_t bits, uint8_t i) const;
-
         class SelectIndex {
         public:
             virtual ~SelectIndex() = 0;
 
-            virtual uint64_t Select(const BitVector *b, uint16_t i) const = 0;
+            // i is the rank of the one in the select block, so it is less than w^2.
+            virtual uint64_t Select(const Payload *b, uint64_t i) const = 0;
 
             virtual size_t n_bytes() const = 0;
         };
 
         class SelectIndexArray : public SelectIndex {
         public:
-            SelectIndexArray(const BitVector *b, const std::vector<uint64_t> &s)
-                    : s_(s) {}
+            SelectIndexArray(const Payload *b, uint64_t first, uint64_t last, uint64_t n_ones);
 
             ~SelectIndexArray() override {}
 
-            uint64_t Select(const BitVector *b, uint16_t i) const override {
+            uint64_t Select(const Payload *b, uint64_t i) const override {
                 return s_[i];
             }
 
@@ -118,10 +111,41 @@ namespace succinct_bv {
             std::vector<uint64_t> s_;
         };
 
+        /**
+         darray-style select index for dense blocks.
+         Stores the position of every kSampleRate-th one relative to the first one in the block,
+         and finishes a query by scanning at most kMaxScanBlocks small blocks from the sample.
+         */
+        class SelectIndexSampled : public SelectIndex {
+        public:
+            static constexpr uint16_t kSampleRate = 64;
+            static constexpr uint64_t kMaxScanBlocks = 16;
+
+            SelectIndexSampled(const Payload *b, uint64_t first, uint64_t last);
+
+            ~SelectIndexSampled() override {}
+
+            uint64_t Select(const Payload *b, uint64_t i) const override;
+
+            size_t n_bytes() const override {
+                return samples_.capacity() * sizeof(uint32_t);
+            }
+
+            // a block is dense if every kSampleRate ones lie within kMaxScanBlocks small blocks.
+            bool dense() const { return dense_; }
+
+        private:
+            uint64_t first_;
+            uint64_t last_block_index_;
+            bool dense_;
+            // offsets from first_ are less than w^4 because dense blocks are never sparse.
+            std::vector<uint32_t> samples_;
+        };
+
         class SelectIndexTree : public SelectIndex {
         public:
-            SelectIndexTree(const BitVector *b, const std::vector<uint64_t> &s)
-                    : cumsums_(nullptr) { Init(b, s); }
+            SelectIndexTree(const Payload *b, uint64_t first, uint64_t last)
+                    : cumsums_(nullptr) { Init(b, first, last); }
 
             ~SelectIndexTree() override {
 #ifdef _MSC_VER
@@ -131,7 +155,7 @@ namespace succinct_bv {
 #endif
                  }
 
-            uint64_t Select(const BitVector *b, uint16_t i) const override;
+            uint64_t Select(const Payload *b, uint64_t i) const override;
 
             size_t n_bytes() const override {
                 return 8 * n_inner_ * sizeof(uint16_t);
@@ -140,7 +164,7 @@ namespace succinct_bv {
             void Dump() const;
 
         private:
-            void Init(const BitVector *b, const std::vector<uint64_t> &s);
+            void Init(const Payload *b, uint64_t first, uint64_t last);
 
             int height_;
             size_t n_inner_;
@@ -161,14 +185,45 @@ namespace succinct_bv {
             std::vector<uint8_t> select_table_;
         };
 
-        uint64_t n_b_ = 0;
-        // bit vector storing every 1/2 w bits.
-        uint32_t *b_;
-        // store rank at i * w^2 in the bit vector. rank is at most w bits.
-        std::vector<uint64_t> r1_;
-        // store rank at i * 1/2 w in a w^2 bits block. rank is at most 2lg(w) bits.
-        std::vector<uint16_t> r2_;
-        std::vector<std::shared_ptr<SelectIndex> > s_;
+        /**
+         The built structure. It is never modified after Init, so it is shared
+         by copies and read concurrently without locking.
+         */
+        class Payload {
+        public:
+            Payload() : b_(nullptr) {}
+
+            Payload(const Payload &) = delete;
+
+            Payload &operator=(const Payload &) = delete;
+
+            ~Payload() {
+#ifdef _MSC_VER
+                if(this->b_ != nullptr) _aligned_free(b_);
+#else
+                if(this->b_ != nullptr) free(b_);
+#endif
+            }
+
+            // add the index of a select block of n_ones ones whose first one and last one are given.
+            void AddSelectIndex(uint64_t first, uint64_t last, uint64_t n_ones);
+
+            // call f with the position of every one in [first, last].
+            template<class F> void ForEachOne(uint64_t first, uint64_t last, F f) const;
+
+            // number of bits.
+            uint64_t n_ = 0;
+            uint64_t n_b_ = 0;
+            // bit vector storing every 1/2 w bits.
+            uint32_t *b_;
+            // store rank at i * w^2 in the bit vector. rank is at most w bits.
+            std::vector<uint64_t> r1_;
+            // store rank at i * 1/2 w in a w^2 bits block. rank is at most 2lg(w) bits.
+            std::vector<uint16_t> r2_;
+            std::vector<std::unique_ptr<SelectIndex> > s_;
+        };
+
+        std::shared_ptr<const Payload> p_;
         // for compute select, store 8 bits pattern table instead of 1/2 w bits pattern table.
         static inline SelectTable selectTable = SelectTable();
     };
@@ -0,0 +1,75 @@
+#ifndef BIT_VECTOR_BUILDER_H_
+#define BIT_VECTOR_BUILDER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <functional>
+#include <memory>
+
+#include "bit_vector.h"
+
+namespace succinct_bv {
+    /**
+     Builds a BitVector from a stream of bits or words.
+     The bit vector, the rank directory and the select blocks are emitted while bits arrive,
+     so no copy of the input is kept and the peak memory is close to the final structure.
+     Words hold 32 bits with the first bit in the most significant position, as in BitVector.
+     */
+    class BitVectorBuilder {
+    public:
+        // words read from a stream at once.
+        static constexpr size_t kChunkWords = 1 << 14;
+
+        // n_hint is the expected number of bits. memory is reserved once if it is exact.
+        explicit BitVectorBuilder(uint64_t n_hint = 0);
+
+        // copies would append into the same payload, so the builder is only movable.
+        BitVectorBuilder(const BitVectorBuilder &) = delete;
+
+        BitVectorBuilder &operator=(const BitVectorBuilder &) = delete;
+
+        BitVectorBuilder(BitVectorBuilder &&) = default;
+
+        BitVectorBuilder &operator=(BitVectorBuilder &&) = default;
+
+        void PushBack(bool bit);
+
+        // append 32 * n_words bits.
+        void Append(const uint32_t *words, size_t n_words);
+
+        // number of bits appended so far.
+        uint64_t size() const { return n_; }
+
+        // the builder is empty after Build.
+        BitVector Build();
+
+        /**
+         Reads words from a callback until it returns 0.
+         The callback fills at most n words in the given buffer and returns the number of filled words.
+         */
+        static BitVector FromCallback(const std::function<size_t(uint32_t *, size_t)> &read,
+                                      uint64_t n_hint = 0);
+
+        // reads n bits stored as words from a file descriptor.
+        static BitVector FromFd(int fd, uint64_t n);
+
+    private:
+        void Reserve(uint64_t n_words);
+
+        void AppendWord(uint32_t word);
+
+        std::shared_ptr<BitVector::Payload> p_;
+        uint64_t n_ = 0;
+        uint64_t capacity_ = 0;
+        // bits of the word not completed yet.
+        uint32_t word_ = 0;
+        uint64_t r1_sum_ = 0;
+        uint64_t r2_sum_ = 0;
+        // #ones and the first one of the select block not completed yet.
+        uint64_t block_ones_ = 0;
+        uint64_t block_first_ = 0;
+    };
+}
+
+#endif // BIT_VECTOR_BUILDER_H_
@@ -0,0 +1,77 @@
+#ifndef BIT_VECTOR_COLLECTION_H_
+#define BIT_VECTOR_COLLECTION_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+#include "bit_vector.h"
+
+namespace succinct_bv {
+    /**
+     Packs many short bit vectors into one BitVector.
+     Members are concatenated, so the bit vector, its rank directory and its select index are shared.
+     Each member only costs an offset in the directory, about 4 bytes.
+     */
+    class BitVectorCollection {
+    public:
+        BitVectorCollection() {};
+
+        BitVectorCollection(const std::vector<std::deque<bool> > &vs) { Init(vs); }
+
+        BitVectorCollection(const std::vector<std::vector<bool> > &vs) { Init(vs); }
+
+        // number of members.
+        size_t size() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+
+        // number of bits in k-th member.
+        uint64_t Length(size_t k) const {
+            CheckMember(k);
+            return Offset(k + 1) - Offset(k);
+        }
+
+        bool At(size_t k, uint64_t x) const {
+            CheckMember(k);
+            return bv_.At(Offset(k) + x);
+        }
+
+        uint64_t Rank(size_t k, uint64_t x) const {
+            CheckMember(k);
+            uint64_t offset = Offset(k);
+            return bv_.Rank(offset + x) - OnesBefore(offset);
+        }
+
+        uint64_t Select(size_t k, uint64_t i) const;
+
+        size_t n_bytes() const;
+
+    private:
+        template<class T> void Init(const std::vector<T> &vs);
+
+        void CheckMember(size_t k) const {
+            if (offsets_.empty()) throw std::runtime_error("Bitvector is empty.");
+            if (k >= size()) throw std::runtime_error("Member index is out of range.");
+        }
+
+        uint64_t Offset(size_t k) const {
+            return offset_samples_[k / kSampleRate] + offsets_[k];
+        }
+
+        uint64_t OnesBefore(uint64_t offset) const {
+            return offset == 0 ? 0 : bv_.Rank(offset - 1);
+        }
+
+        static constexpr size_t kSampleRate = 64;
+
+        BitVector bv_;
+        // store offset of every kSampleRate-th member in the bit vector.
+        std::vector<uint64_t> offset_samples_;
+        // store offset of each member relative to its sample. the last entry is the total length.
+        std::vector<uint32_t> offsets_;
+    };
+}
+
+#endif // BIT_VECTOR_COLLECTION_H_
@@ -0,0 +1,95 @@
+#ifndef EXTERNAL_BIT_VECTOR_H_
+#define EXTERNAL_BIT_VECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace succinct_bv {
+    /**
+     Bit vector whose bits stay in a file and are read in pages through an LRU cache.
+     The file holds 32-bit words with the first bit in the most significant position,
+     the same layout as BitVectorBuilder::FromFd.
+     Only the rank directory and the select samples are resident,
+     so At, Rank and Select read at most one page.
+     */
+    class ExternalBitVector {
+    public:
+        // pages are split into 512 bits chunks of the rank directory.
+        static constexpr size_t kChunkBits = 512;
+
+        ExternalBitVector(const std::string &path, uint64_t n, size_t page_size = 4096,
+                          size_t cache_bytes = 64 << 20);
+
+        ExternalBitVector(const ExternalBitVector &) = delete;
+
+        ExternalBitVector &operator=(const ExternalBitVector &) = delete;
+
+        ~ExternalBitVector();
+
+        bool At(uint64_t x) const;
+
+        uint64_t Rank(uint64_t x) const;
+
+        uint64_t Select(uint64_t i) const;
+
+        // number of bits.
+        uint64_t size() const { return n_; }
+
+        // resident bytes of the directory and the cached pages.
+        size_t n_bytes() const;
+
+        uint64_t hits() const { return hits_; }
+
+        uint64_t misses() const { return misses_; }
+
+        void ResetCounters() {
+            hits_ = 0;
+            misses_ = 0;
+        }
+
+        // writes v in the layout read by ExternalBitVector.
+        static void Write(const std::string &path, const std::vector<bool> &v);
+
+    private:
+        typedef std::shared_ptr<const std::vector<uint32_t> > Page;
+
+        void InitIndex();
+
+        Page GetPage(uint64_t page_index) const;
+
+        // #ones before the given chunk.
+        uint64_t RankChunk(uint64_t chunk) const {
+            return r1_[chunk / (64 * 64 / kChunkBits)] + r2_[chunk];
+        }
+
+        int fd_;
+        uint64_t n_;
+        size_t page_size_;
+        size_t page_words_;
+        size_t max_pages_;
+        uint64_t n_ones_ = 0;
+        // store rank at i * w^2 in the bit vector.
+        std::vector<uint64_t> r1_;
+        // store rank at i * kChunkBits in a w^2 bits block.
+        std::vector<uint16_t> r2_;
+        // store the chunk containing every w^2-th one.
+        std::vector<uint64_t> s_;
+
+        mutable std::mutex mutex_;
+        // most recently used page first.
+        mutable std::list<std::pair<uint64_t, Page> > lru_;
+        mutable std::unordered_map<uint64_t, std::list<std::pair<uint64_t, Page> >::iterator> pages_;
+        mutable std::atomic<uint64_t> hits_{0};
+        mutable std::atomic<uint64_t> misses_{0};
+    };
+}
+
+#endif // EXTERNAL_BIT_VECTOR_H_
@@ -0,0 +1,83 @@
+#ifndef HYBRID_BIT_VECTOR_H_
+#define HYBRID_BIT_VECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <deque>
+#include <vector>
+
+namespace succinct_bv {
+    /**
+     Roaring-like bit vector. The bits are split into chunks of 2^16 bits,
+     and each chunk is stored as a sorted array of positions, a bitmap or a list of runs of ones,
+     whichever is the smallest. Cumulative #ones before each chunk answers global Rank and Select.
+     */
+    class HybridBitVector {
+    public:
+        static constexpr uint64_t kChunkBits = 1 << 16;
+
+        HybridBitVector() {};
+
+        HybridBitVector(const std::deque<bool> &v) { Init(v); }
+
+        HybridBitVector(const std::vector<bool> &v) { Init(v); }
+
+        bool At(uint64_t x) const;
+
+        uint64_t Rank(uint64_t x) const;
+
+        uint64_t Select(uint64_t i) const;
+
+        // number of bits.
+        uint64_t size() const { return n_; }
+
+        size_t n_bytes() const;
+
+        // number of chunks stored as array, bitmap and runs.
+        size_t n_arrays() const { return Count(kArray); }
+
+        size_t n_bitmaps() const { return Count(kBitmap); }
+
+        size_t n_runs() const { return Count(kRun); }
+
+    private:
+        enum Type : uint8_t { kArray, kBitmap, kRun };
+
+        struct Chunk {
+            // offset in values_ for arrays and runs, offset in bitmaps_ for bitmaps.
+            uint64_t offset;
+            // #positions of an array or #runs.
+            uint32_t size;
+            Type type;
+        };
+
+        template<class T> void Init(const T &v);
+
+        void AddChunk(const uint32_t *bits, uint32_t n_ones, uint32_t n_runs);
+
+        // #ones in [0..y] of the chunk.
+        uint64_t RankInChunk(const Chunk &chunk, uint32_t y) const;
+
+        // position of the i-th one in the chunk.
+        uint32_t SelectInChunk(const Chunk &chunk, uint32_t i) const;
+
+        // the last run of the chunk starting at or before y, or chunk.size if none.
+        uint32_t FindRun(const Chunk &chunk, uint32_t y) const;
+
+        size_t Count(Type type) const;
+
+        uint64_t n_ = 0;
+        std::vector<Chunk> chunks_;
+        // #ones before each chunk. the last entry is #ones.
+        std::vector<uint64_t> cumsums_;
+        // positions of arrays, and (first, last, #ones before) of runs in chunks.
+        std::vector<uint16_t> values_;
+        // bitmap chunks use 2048 words with the first bit in the most significant position.
+        std::vector<uint32_t> bitmaps_;
+        // #ones before every 512 bits in each bitmap chunk.
+        std::vector<uint16_t> bitmap_ranks_;
+    };
+}
+
+#endif // HYBRID_BIT_VECTOR_H_
@@ -0,0 +1,65 @@
+#ifndef PACKED_SYMBOL_VECTOR_H_
+#define PACKED_SYMBOL_VECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace succinct_bv {
+    /**
+     Sequence of kBits-bit symbols (2 for DNA, 4 for small alphabets) with Rank for every symbol.
+     Each 64-byte cache line starts with the 16-bit count of every symbol from the superblock start,
+     followed by the packed symbols, so Rank of one or all symbols touches one line
+     and one superblock entry. Superblocks store 64-bit counts like r1_ in BitVector.
+     */
+    template<int kBits>
+    class PackedSymbolVector {
+        static_assert(kBits == 2 || kBits == 4, "symbols are 2 or 4 bits.");
+
+    public:
+        static constexpr uint64_t kSigma = uint64_t(1) << kBits;
+        static constexpr uint64_t kCountWords = kSigma * 16 / 64;
+        static constexpr uint64_t kDataWords = 8 - kCountWords;
+        static constexpr uint64_t kSymbolsPerWord = 64 / kBits;
+        // 224 symbols for 2 bits, 64 symbols for 4 bits.
+        static constexpr uint64_t kSymbolsPerLine = kDataWords * kSymbolsPerWord;
+        // the count at the start of the last line of a superblock fits in 16 bits.
+        static constexpr uint64_t kLinesPerSuperblock = kBits == 2 ? 256 : 1024;
+
+        PackedSymbolVector() {};
+
+        // symbols are the kBits low bits of each byte.
+        PackedSymbolVector(const std::vector<uint8_t> &v) { Init(v); }
+
+        uint8_t At(uint64_t x) const;
+
+        // #c in [0..x]. c must be less than kSigma.
+        uint64_t Rank(uint8_t c, uint64_t x) const;
+
+        // #c in [0..x] for every symbol c.
+        std::array<uint64_t, kSigma> RankAll(uint64_t x) const;
+
+        // number of symbols.
+        uint64_t size() const { return n_; }
+
+        size_t n_bytes() const;
+
+    private:
+        void Init(const std::vector<uint8_t> &v);
+
+        // #c in the first m symbols of the data words of a line.
+        static uint64_t CountInLine(const uint64_t *words, uint8_t c, uint64_t m);
+
+        uint64_t n_ = 0;
+        uint64_t n_lines_ = 0;
+        // lines of 8 words aligned to 64 bytes, shared by copies.
+        std::shared_ptr<const uint64_t> lines_;
+        // #c before each superblock at i * kSigma + c.
+        std::vector<uint64_t> r1_;
+    };
+}
+
+#endif // PACKED_SYMBOL_VECTOR_H_
@@ -0,0 +1,88 @@
+#ifndef QUERY_EXECUTOR_H_
+#define QUERY_EXECUTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bit_vector.h"
+
+namespace succinct_bv {
+    /**
+     Answers batches of At, Rank and Select queries on a BitVector with a pool of workers.
+     Queries are bucketed into regions of up to kBlocksPerRegion consecutive w^2 bits blocks (Rank, At)
+     or select blocks (Select), so that the queries of a region hit data that stays in cache.
+     Each worker takes a contiguous range of regions and steals regions from others when idle.
+     Answers are returned in the order of the queries.
+     */
+    class QueryExecutor {
+    public:
+        struct Query {
+            enum Type : uint8_t { kAt, kRank, kSelect };
+
+            Type type;
+            uint64_t x;
+        };
+
+        // 64 blocks of w^2 bits are 32KiB of bits and 8KiB of rank directory.
+        static constexpr uint64_t kBlocksPerRegion = 64;
+        // regions are made smaller when a kind of query would have fewer regions per worker.
+        static constexpr uint64_t kMinRegionsPerThread = 16;
+
+        // the calling thread is one of the workers.
+        explicit QueryExecutor(size_t n_threads = std::thread::hardware_concurrency());
+
+        QueryExecutor(const QueryExecutor &) = delete;
+
+        QueryExecutor &operator=(const QueryExecutor &) = delete;
+
+        ~QueryExecutor();
+
+        // At is answered as 0 or 1. concurrent calls are answered one batch after another.
+        std::vector<uint64_t> Execute(const BitVector &bv, const std::vector<Query> &queries);
+
+        size_t n_threads() const { return queues_.size(); }
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<size_t> tasks;
+        };
+
+        // calls job(task) for every task in [0, n_tasks) and returns when all are done.
+        // worker w starts with the w-th contiguous range of tasks.
+        void Run(size_t n_tasks, const std::function<void(size_t)> &job);
+
+        void Loop(size_t worker);
+
+        void Work(size_t worker, const std::function<void(size_t)> &job);
+
+        // own tasks are taken from the front, stolen tasks from the back.
+        bool Pop(size_t worker, size_t &task);
+
+        // held for a whole Execute, since a batch owns the queues and the job state below.
+        std::mutex execute_mutex_;
+        std::vector<std::unique_ptr<Queue> > queues_;
+        std::vector<std::thread> threads_;
+
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        uint64_t generation_ = 0;
+        bool stop_ = false;
+        // workers inside the current job.
+        size_t active_ = 0;
+        const std::function<void(size_t)> *job_ = nullptr;
+        std::atomic<size_t> remaining_{0};
+    };
+}
+
+#endif // QUERY_EXECUTOR_H_
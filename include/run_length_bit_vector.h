@@ -0,0 +1,66 @@
+#ifndef RUN_LENGTH_BIT_VECTOR_H_
+#define RUN_LENGTH_BIT_VECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <deque>
+#include <vector>
+
+#include "bit_vector.h"
+
+namespace succinct_bv {
+    /**
+     Bit vector stored as runs of ones, for vectors made of a few long runs.
+     Each run keeps its first position and #ones before it, so the space is 16 bytes per run
+     regardless of the length, and every query is a binary search in O(log #runs).
+     */
+    class RunLengthBitVector {
+    public:
+        RunLengthBitVector() {};
+
+        RunLengthBitVector(const std::deque<bool> &v) { Init(v); }
+
+        RunLengthBitVector(const std::vector<bool> &v) { Init(v); }
+
+        // finds runs with Rank and Select, in O(#runs * log n).
+        explicit RunLengthBitVector(const BitVector &bv);
+
+        bool At(uint64_t x) const;
+
+        uint64_t Rank(uint64_t x) const;
+
+        uint64_t Select(uint64_t i) const;
+
+        // position of the i-th zero from the head.
+        uint64_t Select0(uint64_t i) const;
+
+        BitVector ToBitVector() const;
+
+        // number of bits.
+        uint64_t size() const { return n_; }
+
+        // number of runs of ones.
+        size_t n_runs() const { return starts_.size(); }
+
+        size_t n_bytes() const {
+            return starts_.capacity() * sizeof(uint64_t) + cumsums_.capacity() * sizeof(uint64_t);
+        }
+
+    private:
+        template<class T> void Init(const T &v);
+
+        // the last run starting at or before x, or n_runs() if none.
+        size_t FindRun(uint64_t x) const;
+
+        uint64_t Length(size_t r) const { return cumsums_[r + 1] - cumsums_[r]; }
+
+        uint64_t n_ = 0;
+        // first position of each run of ones.
+        std::vector<uint64_t> starts_;
+        // #ones before each run. the last entry is #ones.
+        std::vector<uint64_t> cumsums_;
+    };
+}
+
+#endif // RUN_LENGTH_BIT_VECTOR_H_
@@ -0,0 +1,196 @@
+#include "balanced_parentheses.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+using namespace succinct_bv;
+
+BalancedParentheses::ExcessTable::ExcessTable() {
+    for (int i = 0; i < 256; ++i) {
+        int excess = 0;
+        int min = 8;
+
+        for (int j = 7; j >= 0; --j) {
+            excess += (i >> j) & 1 ? 1 : -1;
+            min = std::min(min, excess);
+        }
+
+        excess_[i] = static_cast<int8_t>(excess);
+        min_[i] = static_cast<int8_t>(min);
+    }
+}
+
+void BalancedParentheses::Init() {
+    n_ = bv_.size();
+
+    if (n_ == 0) {
+        throw std::runtime_error("Given container is empty.");
+    }
+
+    n_blocks_ = (n_ + kBlockBits - 1) / kBlockBits;
+    n_leaves_ = 1;
+
+    while (n_leaves_ < n_blocks_)
+        n_leaves_ *= 2;
+
+    leaf_mins_.resize(n_blocks_);
+
+    for (uint64_t b = 0; b < n_blocks_; ++b) {
+        uint64_t end = std::min(n_, (b + 1) * kBlockBits);
+        int64_t excess = 0;
+        int64_t min = kBlockBits;
+
+        for (uint64_t j = b * kBlockBits; j < end;) {
+            if (j + 8 <= end) {
+                uint8_t byte = Byte(j);
+                min = std::min<int64_t>(min, excess + excessTable.min_[byte]);
+                excess += excessTable.excess_[byte];
+                j += 8;
+            } else {
+                excess += At(j) ? 1 : -1;
+                min = std::min(min, excess);
+                ++j;
+            }
+        }
+
+        leaf_mins_[b] = static_cast<int16_t>(min);
+    }
+
+    mins_.assign(n_leaves_, std::numeric_limits<int64_t>::max());
+
+    for (uint64_t u = n_leaves_ - 1; u >= 1; --u)
+        mins_[u] = std::min(Min(2 * u), Min(2 * u + 1));
+}
+
+int64_t BalancedParentheses::Min(uint64_t u) const {
+    if (u < n_leaves_) return mins_[u];
+
+    uint64_t b = u - n_leaves_;
+
+    // leaves after the last block never match.
+    if (b >= n_blocks_) return std::numeric_limits<int64_t>::max();
+
+    return BlockBase(b) + leaf_mins_[b];
+}
+
+uint64_t BalancedParentheses::ScanForward(uint64_t from, int64_t excess, int64_t t) const {
+    uint64_t end = std::min(n_, (from / kBlockBits + 1) * kBlockBits);
+    uint64_t j = from;
+
+    for (; j < end && j % 8 != 0; ++j) {
+        excess += At(j) ? 1 : -1;
+        if (excess <= t) return j;
+    }
+
+    // skip bytes whose minimum excess is above t.
+    for (; j + 8 <= end; j += 8) {
+        uint8_t byte = Byte(j);
+        if (excess + excessTable.min_[byte] <= t) break;
+        excess += excessTable.excess_[byte];
+    }
+
+    for (; j < end; ++j) {
+        excess += At(j) ? 1 : -1;
+        if (excess <= t) return j;
+    }
+
+    return npos;
+}
+
+uint64_t BalancedParentheses::ScanBackward(uint64_t from, int64_t excess, int64_t t) const {
+    int64_t start = static_cast<int64_t>(from / kBlockBits * kBlockBits);
+    int64_t k = static_cast<int64_t>(from);
+
+    // excess is Excess(k) at each step.
+    for (; k >= start && (k + 1) % 8 != 0; --k) {
+        if (excess <= t) return k;
+        excess -= At(k) ? 1 : -1;
+    }
+
+    // skip bytes whose minimum excess is above t.
+    for (; k - 7 >= start; k -= 8) {
+        uint8_t byte = Byte(k - 7);
+        int64_t before = excess - excessTable.excess_[byte];
+        if (before + excessTable.min_[byte] <= t) break;
+        excess = before;
+    }
+
+    for (; k >= start; --k) {
+        if (excess <= t) return k;
+        excess -= At(k) ? 1 : -1;
+    }
+
+    return npos;
+}
+
+uint64_t BalancedParentheses::FwdSearch(uint64_t i, int64_t t) const {
+    uint64_t b = i / kBlockBits;
+
+    if (i + 1 < n_ && (i + 1) / kBlockBits == b) {
+        uint64_t j = ScanForward(i + 1, Excess(i), t);
+        if (j != npos) return j;
+    }
+
+    // climb to the first right sibling reaching t, then descend to its leftmost block reaching t.
+    uint64_t u = n_leaves_ + b;
+
+    while (u > 1) {
+        if (u % 2 == 0 && Min(u + 1) <= t) {
+            ++u;
+            break;
+        }
+
+        u /= 2;
+    }
+
+    if (u == 1) return npos;
+
+    while (u < n_leaves_)
+        u = Min(2 * u) <= t ? 2 * u : 2 * u + 1;
+
+    b = u - n_leaves_;
+    return ScanForward(b * kBlockBits, BlockBase(b), t);
+}
+
+uint64_t BalancedParentheses::BwdSearch(uint64_t i, int64_t t) const {
+    uint64_t b = i / kBlockBits;
+
+    if (i > 0 && (i - 1) / kBlockBits == b) {
+        uint64_t k = ScanBackward(i - 1, Excess(i - 1), t);
+        if (k != npos) return k + 1;
+    }
+
+    // climb to the first left sibling reaching t, then descend to its rightmost block reaching t.
+    uint64_t u = n_leaves_ + b;
+
+    while (u > 1) {
+        if (u % 2 == 1 && Min(u - 1) <= t) {
+            --u;
+            break;
+        }
+
+        u /= 2;
+    }
+
+    if (u == 1) return t >= 0 ? 0 : npos;
+
+    while (u < n_leaves_)
+        u = Min(2 * u + 1) <= t ? 2 * u + 1 : 2 * u;
+
+    b = u - n_leaves_;
+    uint64_t last = std::min(n_, (b + 1) * kBlockBits) - 1;
+    return ScanBackward(last, Excess(last), t) + 1;
+}
+
+uint64_t BalancedParentheses::FindClose(uint64_t i) const {
+    return FwdSearch(i, Excess(i) - 1);
+}
+
+uint64_t BalancedParentheses::FindOpen(uint64_t i) const {
+    return BwdSearch(i, Excess(i));
+}
+
+uint64_t BalancedParentheses::Enclose(uint64_t i) const {
+    return BwdSearch(i, Excess(i) - 2);
+}
@@ -1,4 +1,5 @@
 #include "bit_vector.h"
+#include "bit_vector_builder.h"
 
 #include <cstdlib>
 #include <cmath>
@@ -26,26 +27,14 @@
 using std::vector;
 using namespace succinct_bv;
 
-BitVector::BitVector(const BitVector &copy) : b_(nullptr) {
-    this->n_b_ = copy.n_b_;
-    if(copy.b_ != nullptr) {
-        posix_memalign((void **) &b_, 32, n_b_ * sizeof(uint32_t));
-        std::copy(copy.b_, copy.b_ + copy.n_b_, this->b_);
-    }
-    this->r1_.resize(copy.r1_.size());
-    std::copy(copy.r1_.begin(),copy.r1_.end(), this->r1_.begin());
-    this->r2_.resize(copy.r2_.size());
-    std::copy(copy.r2_.begin(),copy.r2_.end(), this->r2_.begin());
-    this->s_.resize(copy.s_.size());
-    std::copy(copy.s_.begin(),copy.s_.end(), this->s_.begin());
-}
+BitVector::BitVector(const BitVector &copy) : p_(copy.p_) {}
 
-BitVector::BitVector(BitVector &&copy) : b_(nullptr) {
+BitVector::BitVector(BitVector &&copy) {
     swap(*this, copy);
 }
 
-BitVector & BitVector::operator=(BitVector bv) {
-    swap(*this, bv);
+BitVector & BitVector::operator=(const BitVector &bv) {
+    p_ = bv.p_;
     return *this;
 }
 
@@ -55,169 +44,95 @@ BitVector & BitVector::operator=(BitVector &&copy) noexcept {
 }
 
 BitVector & BitVector::operator=(std::deque<bool> &&bv) {
-#ifdef _MSC_VER
-    if(this->b_ != nullptr) _aligned_free(this->b_);
-#else
-    if(this->b_ != nullptr) free(b_);
-#endif
-    b_ = nullptr;
-    this->n_b_ = 0;
-    this->r1_ = {};
-    this->r2_ = {};
-    this->s_ = {};
     Init(bv);
     return *this;
 }
 
 BitVector & BitVector::operator=(std::vector<bool> &&bv) {
-#ifdef _MSC_VER
-    if(this->b_ != nullptr) _aligned_free(this->b_);
-#else
-    if(this->b_ != nullptr) free(b_);
-#endif
-    b_ = nullptr;
-    this->n_b_ = 0;
-    this->r1_ = {};
-    this->r2_ = {};
-    this->s_ = {};
     Init(bv);
     return *this;
 }
 
 BitVector & BitVector::operator=(const std::deque<bool> &bv) {
-
-#ifdef _MSC_VER
-    if(this->b_ != nullptr) _aligned_free(this->b_);
-#else
-    if(this->b_ != nullptr) free(b_);
-#endif
-    b_ = nullptr;
-    this->n_b_ = 0;
-    this->r1_ = {};
-    this->r2_ = {};
-    this->s_ = {};
     Init(bv);
     return *this;
 }
 
 BitVector & BitVector::operator=(const std::vector<bool> &bv) {
-
-#ifdef _MSC_VER
-    if(this->b_ != nullptr) _aligned_free(this->b_);
-#else
-    if(this->b_ != nullptr) free(b_);
-#endif
-    b_ = nullptr;
-    this->n_b_ = 0;
-    this->r1_ = {};
-    this->r2_ = {};
-    this->s_ = {};
     Init(bv);
     return *this;
 }
 
 void swap(succinct_bv::BitVector& a, succinct_bv::BitVector& b) {
     using std::swap;
-    swap(a.b_,b.b_);
-    swap(a.n_b_,b.n_b_);
-    swap(a.r1_,b.r1_);
-    swap(a.r2_,b.r2_);
-    swap(a.s_,b.s_);
+    swap(a.p_,b.p_);
 }
 
 template<class T>
-void BitVector::InitVector(const T &v) {
-    uint64_t n = v.size();
-    n_b_ = n / 32 + 1;
-    posix_memalign((void**)&b_, 32, n_b_ * sizeof(uint32_t));
+void BitVector::Init(const T &v) {
+    if (v.empty()) {
+        throw std::runtime_error("Given container is empty.");
+    }
 
-    if (b_ == nullptr)
-        throw std::runtime_error("Could not allocate memory for bit vector.");
+    BitVectorBuilder builder(v.size());
 
-    for (uint64_t i = 0; i < n_b_; ++i)
-        b_[i] = 0;
+    for (uint64_t i = 0, n = v.size(); i < n; ++i)
+        builder.PushBack(v[i]);
 
-    for (uint64_t i = 0; i < n; ++i)
-        if (v[i]) b_[i / 32] |= 1u << (32 - 1 - (i % 32));
+    p_ = builder.Build().p_;
 }
 
-template void BitVector::InitVector<std::deque<bool> >(
+template void BitVector::Init<std::deque<bool> >(
 const std::deque<bool> &v);
 
-template void BitVector::InitVector<std::vector<bool> >(
+template void BitVector::Init<std::vector<bool> >(
 const std::vector<bool> &v);
 
 bool BitVector::At(uint64_t x) const {
-    if (b_ == nullptr) throw std::runtime_error("Bitvector is empty.");
-    return (b_[x / 32] & (1 << (31 - x % 32)));
+    if (p_ == nullptr) throw std::runtime_error("Bitvector is empty.");
+    return (p_->b_[x / 32] & (1u << (31 - x % 32)));
 }
 
 //std::vector<uint8_t> BitVector::select_table_ = std::vector<uint8_t>();
 
-void BitVector::InitRankIndex() {
-    // the number of w^2 bits blocks is [n/w^2]+1.
-    // every w^2 bits block contains 2w small (1/2 w bits) blocks.
-    r1_.reserve(n_b_ / (2 * 64) + 1);
-    // the number of 1/2 w bits blocks is [2n/w]+1.
-    r2_.reserve(n_b_);
-
-    uint64_t r1_sum = 0;
-    uint64_t r2_sum = 0;
-
-    for (uint64_t i = 0; i < n_b_; ++i) {
-        if (i % (2 * 64) == 0) {
-            r1_.push_back(r1_sum);
-            r2_sum = 0;
-        }
-
-        r2_.push_back(static_cast<uint16_t>(r2_sum));
-        uint64_t count = _mm_popcnt_u32(b_[i]);
-        r1_sum += count;
-        r2_sum += count;
-    }
-}
-
 uint64_t BitVector::Rank(uint64_t x) const {
-    if (b_ == nullptr) throw std::runtime_error("Bitvector is empty.");
+    if (p_ == nullptr) throw std::runtime_error("Bitvector is empty.");
+    const Payload &p = *p_;
     size_t r2_index = x / 32;
-    uint32_t bits = b_[r2_index] >> (32 - 1 - (x % 32));
+    uint32_t bits = p.b_[r2_index] >> (32 - 1 - (x % 32));
 
     // popcnt instruction is used instead of the pattern table for 1/2 w bits.
-    return r1_[x / (64 * 64)] + r2_[r2_index] + _mm_popcnt_u32(bits);
+    return p.r1_[x / (64 * 64)] + p.r2_[r2_index] + _mm_popcnt_u32(bits);
 }
 
-void BitVector::InitSelectIndex() {
-    //InitSelectTable();
-
-    vector<uint64_t> s;
-    vector<uint64_t> next_s;
-
-    for (uint64_t i = 0; i < n_b_; ++i) {
-        uint8_t count = _mm_popcnt_u32(b_[i]);
-
-        for (uint8_t j = 0; j < count; ++j)
-            s.push_back(i * 32 + static_cast<uint64_t>(SelectOn32bits(b_[i], j)));
+void BitVector::Payload::AddSelectIndex(uint64_t first, uint64_t last, uint64_t n_ones) {
+    // a block is sparse if the size of block > w^4 bits.
+    // a dense block samples every kSampleRate-th one instead of building the tree.
+    if ((last - first + 1) > 64 * 64 * 64 * 64) {
+        s_.push_back(std::make_unique<SelectIndexArray>(this, first, last, n_ones));
+        return;
+    }
 
-        if (s.size() > (64 * 64)) {
-            for (size_t j = 64 * 64; j < s.size(); ++j)
-                next_s.push_back(s[j]);
+    auto sampled = std::make_unique<SelectIndexSampled>(this, first, last);
 
-            s.resize(64 * 64);
-        }
+    if (sampled->dense())
+        s_.push_back(std::move(sampled));
+    else
+        s_.push_back(std::make_unique<SelectIndexTree>(this, first, last));
+}
 
-        // a block contains w^2 ones.
-        if ((s.size() == (64 * 64)) || (i == n_b_ - 1)) {
+template<class F>
+void BitVector::Payload::ForEachOne(uint64_t first, uint64_t last, F f) const {
+    for (uint64_t i = first / 32; i <= last / 32; ++i) {
+        uint32_t bits = b_[i];
 
-            // a block is sparse if the size of block > w^4 bits.
-            if(!s.empty()) {
-                if ((s.back() - s.front() + 1) > 64 * 64 * 64 * 64)
-                    s_.push_back(std::make_shared<SelectIndexArray>(this, s));
-                else
-                    s_.push_back(std::make_shared<SelectIndexTree>(this, s));
-            }
+        if (i == first / 32) bits &= 0xffffffffu >> (first % 32);
+        if (i == last / 32) bits &= 0xffffffffu << (31 - last % 32);
 
-            s.clear();
-            s.swap(next_s);
+        while (bits != 0) {
+            uint32_t j = 31 - _lzcnt_u32(bits);
+            f(i * 32 + 31 - j);
+            bits &= ~(1u << j);
         }
     }
 }
@@ -260,7 +175,7 @@ BitVector::SelectTable::SelectTable() {
     }
 }
 
-uint8_t BitVector::SelectOn32bits(uint32_t bits, uint8_t i) const {
+uint8_t BitVector::SelectOn32bits(uint32_t bits, uint8_t i) {
     uint8_t j = 0;
 
     while (j < 4) {
@@ -274,26 +189,77 @@ uint8_t BitVector::SelectOn32bits(uint32_t bits, uint8_t i) const {
 }
 
 size_t BitVector::n_bytes() const {
-    size_t n = n_b_ * sizeof(uint32_t);
-    n += r1_.capacity() * sizeof(uint64_t) + r2_.capacity() * sizeof(uint16_t);
+    size_t n = selectTable.select_table_.capacity() * sizeof(uint8_t);
 
-    for (auto &v : s_)
-        n += v->n_bytes();
+    if (p_ == nullptr) return n;
 
-    n += selectTable.select_table_.capacity() * sizeof(uint8_t);
+    const Payload &p = *p_;
+    n += p.n_b_ * sizeof(uint32_t);
+    n += p.r1_.capacity() * sizeof(uint64_t) + p.r2_.capacity() * sizeof(uint16_t);
+
+    for (auto &v : p.s_)
+        n += v->n_bytes();
 
     return n;
 }
 
 BitVector::SelectIndex::~SelectIndex() {}
 
-void BitVector::SelectIndexTree::Init(const BitVector *b,
-                                      const std::vector<uint64_t> &s) {
-    first_block_index_ = s.front() / 32;
+BitVector::SelectIndexArray::SelectIndexArray(const Payload *b, uint64_t first, uint64_t last,
+                                              uint64_t n_ones) {
+    // the last block of the bit vector may have less than w^2 ones.
+    s_.reserve(n_ones);
+    b->ForEachOne(first, last, [this](uint64_t x) { s_.push_back(x); });
+}
+
+BitVector::SelectIndexSampled::SelectIndexSampled(const Payload *b, uint64_t first, uint64_t last)
+        : first_(first), last_block_index_(last / 32), dense_(true) {
+    samples_.reserve(64 * 64 / kSampleRate);
+    uint16_t count = 0;
+    uint64_t sample = first;
+
+    b->ForEachOne(first, last, [&](uint64_t x) {
+        uint16_t rank = count++ % kSampleRate;
+
+        if (rank == 0) {
+            samples_.push_back(static_cast<uint32_t>(x - first_));
+            sample = x;
+        }
+
+        if (rank == kSampleRate - 1 && x / 32 - sample / 32 + 1 > kMaxScanBlocks)
+            dense_ = false;
+    });
+
+    // the last sample may be followed by less than kSampleRate ones.
+    if (last / 32 - sample / 32 + 1 > kMaxScanBlocks) dense_ = false;
+}
+
+uint64_t BitVector::SelectIndexSampled::Select(const Payload *b, uint64_t i) const {
+    uint64_t position = first_ + samples_[i / kSampleRate];
+    uint8_t rest = static_cast<uint8_t>(i % kSampleRate);
+    uint64_t block_index = position / 32;
+    // drop the ones before the sampled position in its small block.
+    uint32_t bits = b->b_[block_index] & (0xffffffffu >> (position % 32));
+
+    // at most kMaxScanBlocks small blocks are visited for i in range.
+    while (true) {
+        uint8_t count = _mm_popcnt_u32(bits);
+        if (rest < count) break;
+        rest -= count;
+        // i is past the last one, answer with the first position after this block.
+        if (++block_index > last_block_index_) return block_index * 32;
+        bits = b->b_[block_index];
+    }
+
+    return block_index * 32 + SelectOn32bits(bits, rest);
+}
+
+void BitVector::SelectIndexTree::Init(const Payload *b, uint64_t first, uint64_t last) {
+    first_block_index_ = first / 32;
     // the first small block in this block may be the last small block in previous block.
     // if so, add offset.
     uint32_t first_block = b->b_[first_block_index_];
-    int shift = 32 - s.front() % 32;
+    int shift = 32 - first % 32;
 
     if (shift == 32)
         first_block = 0;
@@ -301,7 +267,7 @@ void BitVector::SelectIndexTree::Init(const BitVector *b,
         first_block = b->b_[first_block_index_] >> shift;
 
     first_block_offset_ = _mm_popcnt_u32(first_block);
-    size_t  n_blocks = s.back() / 32 - first_block_index_ + 1;
+    size_t  n_blocks = last / 32 - first_block_index_ + 1;
     size_t  n_generation = 1;
     size_t  n_nodes = 1;
     height_ = 0;
@@ -313,6 +279,8 @@ void BitVector::SelectIndexTree::Init(const BitVector *b,
     }
 
     n_inner_ = n_nodes - n_generation;
+    // a block has at most w^2 ones and the first small block adds less than w/2,
+    // so 16 bits are enough for any node even when the bit vector is larger than 2^32 bits.
     std::vector<int16_t> nodes(n_nodes, 0);
 
     for (size_t i = 0; i < n_blocks; ++i)
@@ -342,8 +310,8 @@ void BitVector::SelectIndexTree::Init(const BitVector *b,
     if (cumsums_ == nullptr)
         throw std::runtime_error("Could not allocate memory.");
 
-    unsigned int offset = 0;
-    unsigned int count = 1;
+    size_t offset = 0;
+    size_t count = 1;
 
     for (int h = 0; h < height_; ++h) {
         for (size_t i = 0; i < count; ++i) {
@@ -362,15 +330,16 @@ void BitVector::SelectIndexTree::Init(const BitVector *b,
     }
 }
 
-uint64_t BitVector::SelectIndexTree::Select(const BitVector *b, uint16_t i) const
+uint64_t BitVector::SelectIndexTree::Select(const Payload *b, uint64_t i) const
 {
-    i += static_cast<uint16_t>(first_block_offset_);
-    unsigned int node = 0;
+    // i is less than w^2 in the block, so the rank fits the 16-bit lanes of cumsums_.
+    uint16_t rank = static_cast<uint16_t>(i + first_block_offset_);
+    size_t node = 0;
     unsigned int child = 0;
 
     //Following Init -> SelectIndexTree() -> InitSelectIndex, height_ should have an upper bound, since s is at most 64 * 64 bit large. Therefore O(1).
     for (int j = 0; j < height_; ++j) {
-        __m128i value = _mm_set_epi16(i, i, i, i, i, i, i, i);
+        __m128i value = _mm_set1_epi16(static_cast<int16_t>(rank));
         __m128i *ptr = reinterpret_cast<__m128i*>(&cumsums_[8 * node]);
         __m128i to_child = _mm_load_si128(ptr);
         __m128i cmp = _mm_cmpgt_epi16(to_child, value);
@@ -378,13 +347,13 @@ uint64_t BitVector::SelectIndexTree::Select(const BitVector *b, uint16_t i) cons
         child = _tzcnt_u32(mask) / 2;
 
         if (child > 0)
-            i -= cumsums_[8 * node + child - 1];
+            rank -= cumsums_[8 * node + child - 1];
 
         node = 8 * node + child + 1;
     }
 
     uint64_t block_index = first_block_index_ + node - n_inner_;
-    uint64_t l = b->SelectOn32bits(b->b_[block_index], static_cast<uint8_t>(i));
+    uint64_t l = SelectOn32bits(b->b_[block_index], static_cast<uint8_t>(rank));
 
     return l + block_index * 32;
 }
@@ -395,10 +364,10 @@ void BitVector::SelectIndexTree::Dump() const {
     size_t count = 1;
 
     for (int h = 0; h < height_; ++h) {
-        for (int i = 0; i < count; ++i) {
+        for (size_t i = 0; i < count; ++i) {
             size_t node = offset + i;
 
-            for (int j = 0; j < 8; ++j)
+            for (size_t j = 0; j < 8; ++j)
                 std::cout << cumsums_[8 * node + j] << ", ";
 
             std::cout << "| ";
@@ -0,0 +1,194 @@
+#include "bit_vector_builder.h"
+
+#include <cstdlib>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <io.h>
+#define read _read
+#else
+#include <unistd.h>
+#endif
+
+#include <nmmintrin.h>
+#include <immintrin.h>
+
+using namespace succinct_bv;
+
+BitVectorBuilder::BitVectorBuilder(uint64_t n_hint)
+        : p_(std::make_shared<BitVector::Payload>()) {
+    // the bit vector always has a last word for the remaining bits.
+    uint64_t n_words = n_hint / 32 + 1;
+    Reserve(n_words);
+    p_->r1_.reserve(n_words / (2 * 64) + 1);
+    p_->r2_.reserve(n_words);
+}
+
+void BitVectorBuilder::Reserve(uint64_t n_words) {
+    uint32_t *b = nullptr;
+    posix_memalign((void **) &b, 32, n_words * sizeof(uint32_t));
+
+    if (b == nullptr)
+        throw std::runtime_error("Could not allocate memory for bit vector.");
+
+    if (p_->b_ != nullptr) {
+        std::copy(p_->b_, p_->b_ + p_->n_b_, b);
+#ifdef _MSC_VER
+        _aligned_free(p_->b_);
+#else
+        free(p_->b_);
+#endif
+    }
+
+    p_->b_ = b;
+    capacity_ = n_words;
+}
+
+void BitVectorBuilder::PushBack(bool bit) {
+    if (bit) word_ |= 1u << (32 - 1 - (n_ % 32));
+    ++n_;
+
+    if (n_ % 32 == 0) {
+        AppendWord(word_);
+        word_ = 0;
+    }
+}
+
+void BitVectorBuilder::Append(const uint32_t *words, size_t n_words) {
+    int shift = n_ % 32;
+
+    for (size_t k = 0; k < n_words; ++k) {
+        if (shift == 0) {
+            AppendWord(words[k]);
+        } else {
+            AppendWord(word_ | (words[k] >> shift));
+            word_ = words[k] << (32 - shift);
+        }
+    }
+
+    n_ += 32 * static_cast<uint64_t>(n_words);
+}
+
+void BitVectorBuilder::AppendWord(uint32_t word) {
+    BitVector::Payload &p = *p_;
+    uint64_t i = p.n_b_;
+
+    if (i == capacity_)
+        Reserve(2 * capacity_);
+
+    p.b_[i] = word;
+    ++p.n_b_;
+
+    // rank directory, same layout as a w^2 bits block of 2w small blocks.
+    if (i % (2 * 64) == 0) {
+        p.r1_.push_back(r1_sum_);
+        r2_sum_ = 0;
+    }
+
+    p.r2_.push_back(static_cast<uint16_t>(r2_sum_));
+    uint8_t count = _mm_popcnt_u32(word);
+    r1_sum_ += count;
+    r2_sum_ += count;
+
+    if (count == 0) return;
+
+    // select blocks contain w^2 ones. a word completes at most one block.
+    if (block_ones_ == 0)
+        block_first_ = i * 32 + BitVector::SelectOn32bits(word, 0);
+
+    if (block_ones_ + count < 64 * 64) {
+        block_ones_ += count;
+        return;
+    }
+
+    uint8_t j = static_cast<uint8_t>(64 * 64 - block_ones_ - 1);
+    p.AddSelectIndex(block_first_, i * 32 + BitVector::SelectOn32bits(word, j), 64 * 64);
+    block_ones_ = block_ones_ + count - 64 * 64;
+
+    if (block_ones_ > 0)
+        block_first_ = i * 32 + BitVector::SelectOn32bits(word, j + 1);
+}
+
+BitVector BitVectorBuilder::Build() {
+    if (n_ == 0) {
+        throw std::runtime_error("Given container is empty.");
+    }
+
+    // the last word holds the remaining bits, and is empty when n is a multiple of w/2.
+    AppendWord(word_);
+
+    BitVector::Payload &p = *p_;
+
+    if (block_ones_ > 0) {
+        uint64_t last = p.n_b_ - 1;
+
+        while (p.b_[last] == 0)
+            --last;
+
+        p.AddSelectIndex(block_first_, last * 32 + 31 - _tzcnt_u32(p.b_[last]), block_ones_);
+    }
+
+    // without an exact hint, doubling may leave up to half of b_ unused.
+    if (capacity_ > p.n_b_)
+        Reserve(p.n_b_);
+
+    p.n_ = n_;
+    p.r1_.shrink_to_fit();
+    p.r2_.shrink_to_fit();
+
+    BitVector bv;
+    bv.p_ = std::move(p_);
+    *this = BitVectorBuilder();
+    return bv;
+}
+
+BitVector BitVectorBuilder::FromCallback(
+        const std::function<size_t(uint32_t *, size_t)> &read, uint64_t n_hint) {
+    BitVectorBuilder builder(n_hint);
+    std::vector<uint32_t> chunk(kChunkWords);
+    size_t n_words;
+
+    while ((n_words = read(chunk.data(), chunk.size())) > 0)
+        builder.Append(chunk.data(), n_words);
+
+    return builder.Build();
+}
+
+BitVector BitVectorBuilder::FromFd(int fd, uint64_t n) {
+    BitVectorBuilder builder(n);
+    std::vector<uint32_t> chunk(kChunkWords);
+    uint64_t n_words = (n + 31) / 32;
+
+    while (n_words > 0) {
+        size_t n_bytes = std::min<uint64_t>(n_words, chunk.size()) * sizeof(uint32_t);
+        char *buffer = reinterpret_cast<char *>(chunk.data());
+        size_t filled = 0;
+
+        while (filled < n_bytes) {
+            auto r = read(fd, buffer + filled, n_bytes - filled);
+
+            if (r <= 0)
+                throw std::runtime_error("Could not read bit vector.");
+
+            filled += static_cast<size_t>(r);
+        }
+
+        size_t k = n_bytes / sizeof(uint32_t);
+        n_words -= k;
+
+        // drop the bits after n in the last word.
+        if (n_words == 0) {
+            builder.Append(chunk.data(), k - 1);
+
+            for (uint64_t x = (n - 1) / 32 * 32; x < n; ++x)
+                builder.PushBack((chunk[k - 1] >> (31 - x % 32)) & 1u);
+        } else {
+            builder.Append(chunk.data(), k);
+        }
+    }
+
+    return builder.Build();
+}
@@ -0,0 +1,65 @@
+#include "bit_vector_collection.h"
+#include "bit_vector_builder.h"
+
+#include <limits>
+#include <stdexcept>
+
+using namespace succinct_bv;
+
+template<class T>
+void BitVectorCollection::Init(const std::vector<T> &vs) {
+    uint64_t n = 0;
+
+    for (auto &v : vs)
+        n += v.size();
+
+    if (n == 0) {
+        throw std::runtime_error("Given container is empty.");
+    }
+
+    // stream members into the builder instead of concatenating them first.
+    BitVectorBuilder builder(n);
+    offset_samples_.reserve(vs.size() / kSampleRate + 1);
+    offsets_.reserve(vs.size() + 1);
+
+    for (size_t k = 0; k <= vs.size(); ++k) {
+        if (k % kSampleRate == 0)
+            offset_samples_.push_back(builder.size());
+
+        uint64_t offset = builder.size() - offset_samples_.back();
+
+        if (offset > std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error("Members are too long for the offset directory.");
+
+        offsets_.push_back(static_cast<uint32_t>(offset));
+
+        if (k < vs.size()) {
+            for (bool bit : vs[k])
+                builder.PushBack(bit);
+        }
+    }
+
+    bv_ = builder.Build();
+}
+
+template void BitVectorCollection::Init<std::deque<bool> >(
+const std::vector<std::deque<bool> > &vs);
+
+template void BitVectorCollection::Init<std::vector<bool> >(
+const std::vector<std::vector<bool> > &vs);
+
+uint64_t BitVectorCollection::Select(size_t k, uint64_t i) const {
+    CheckMember(k);
+    uint64_t offset = Offset(k);
+    uint64_t ones = OnesBefore(offset);
+
+    // same answer as BitVector for a member without ones.
+    if (OnesBefore(Offset(k + 1)) == ones) return 32;
+
+    return bv_.Select(ones + i) - offset;
+}
+
+size_t BitVectorCollection::n_bytes() const {
+    return bv_.n_bytes() + offset_samples_.capacity() * sizeof(uint64_t)
+           + offsets_.capacity() * sizeof(uint32_t);
+}
@@ -0,0 +1,234 @@
+#include "external_bit_vector.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <nmmintrin.h>
+
+#include "bit_vector.h"
+
+using namespace succinct_bv;
+
+ExternalBitVector::ExternalBitVector(const std::string &path, uint64_t n, size_t page_size,
+                                     size_t cache_bytes)
+        : fd_(-1), n_(n), page_size_(page_size) {
+    if (n == 0) {
+        throw std::runtime_error("Given container is empty.");
+    }
+
+    if (page_size == 0 || page_size % (kChunkBits / 8) != 0) {
+        throw std::runtime_error("Page size must be a multiple of 64 bytes.");
+    }
+
+    fd_ = open(path.c_str(), O_RDONLY);
+
+    if (fd_ < 0) {
+        throw std::runtime_error("Could not open " + path + ".");
+    }
+
+    page_words_ = page_size / sizeof(uint32_t);
+    max_pages_ = std::max<size_t>(1, cache_bytes / page_size);
+
+    try {
+        InitIndex();
+    } catch (...) {
+        close(fd_);
+        throw;
+    }
+}
+
+ExternalBitVector::~ExternalBitVector() {
+    if (fd_ >= 0) close(fd_);
+}
+
+void ExternalBitVector::InitIndex() {
+    // the file is read once sequentially, without the page cache of this class.
+    const size_t chunk_words = kChunkBits / 32;
+    std::vector<uint32_t> buffer(64 * 1024);
+    uint64_t n_words = (n_ + 31) / 32;
+    uint64_t n_chunks = (n_words + chunk_words - 1) / chunk_words;
+    r1_.reserve(n_ / (64 * 64) + 1);
+    r2_.reserve(n_chunks);
+
+    uint64_t r2_sum = 0;
+
+    for (uint64_t w = 0; w < n_words; w += buffer.size()) {
+        size_t k = static_cast<size_t>(std::min<uint64_t>(buffer.size(), n_words - w));
+        size_t n_bytes = k * sizeof(uint32_t);
+        char *data = reinterpret_cast<char *>(buffer.data());
+        size_t filled = 0;
+
+        while (filled < n_bytes) {
+            ssize_t r = pread(fd_, data + filled, n_bytes - filled,
+                              static_cast<off_t>(w * sizeof(uint32_t) + filled));
+
+            if (r <= 0)
+                throw std::runtime_error("Could not read bit vector.");
+
+            filled += static_cast<size_t>(r);
+        }
+
+        for (size_t j = 0; j < k; ++j) {
+            uint64_t word_index = w + j;
+            uint32_t bits = buffer[j];
+
+            // ignore the bits after n in the last word.
+            if (word_index == n_words - 1 && n_ % 32 != 0)
+                bits &= 0xffffffffu << (32 - n_ % 32);
+
+            if (word_index % (64 * 64 / 32) == 0) {
+                r1_.push_back(n_ones_);
+                r2_sum = 0;
+            }
+
+            if (word_index % chunk_words == 0)
+                r2_.push_back(static_cast<uint16_t>(r2_sum));
+
+            uint64_t count = _mm_popcnt_u32(bits);
+
+            // a word contains at most one w^2-th one.
+            if (s_.size() * 64 * 64 < n_ones_ + count)
+                s_.push_back(word_index / chunk_words);
+
+            n_ones_ += count;
+            r2_sum += count;
+        }
+    }
+}
+
+ExternalBitVector::Page ExternalBitVector::GetPage(uint64_t page_index) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pages_.find(page_index);
+
+        if (it != pages_.end()) {
+            ++hits_;
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->second;
+        }
+    }
+
+    ++misses_;
+    // read without the lock so that queries on cached pages are not blocked.
+    auto page = std::make_shared<std::vector<uint32_t> >(page_words_, 0);
+    char *data = reinterpret_cast<char *>(page->data());
+    size_t filled = 0;
+
+    while (filled < page_size_) {
+        ssize_t r = pread(fd_, data + filled, page_size_ - filled,
+                          static_cast<off_t>(page_index * page_size_ + filled));
+
+        if (r < 0)
+            throw std::runtime_error("Could not read bit vector.");
+
+        // the last page may be shorter.
+        if (r == 0) break;
+
+        filled += static_cast<size_t>(r);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pages_.find(page_index);
+
+    // another thread may have read the same page.
+    if (it != pages_.end())
+        return it->second->second;
+
+    lru_.emplace_front(page_index, page);
+    pages_[page_index] = lru_.begin();
+
+    if (lru_.size() > max_pages_) {
+        pages_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+
+    return page;
+}
+
+bool ExternalBitVector::At(uint64_t x) const {
+    uint64_t w = x / 32;
+    Page page = GetPage(w / page_words_);
+    return ((*page)[w % page_words_] >> (31 - x % 32)) & 1u;
+}
+
+uint64_t ExternalBitVector::Rank(uint64_t x) const {
+    uint64_t w = x / 32;
+    Page page = GetPage(w / page_words_);
+    const uint32_t *words = page->data();
+    size_t k = w % page_words_;
+    // chunks do not cross pages because a page is a multiple of chunks.
+    size_t j = k - w % (kChunkBits / 32);
+    uint64_t r = RankChunk(x / kChunkBits);
+
+    for (; j < k; ++j)
+        r += _mm_popcnt_u32(words[j]);
+
+    return r + _mm_popcnt_u32(words[k] >> (31 - x % 32));
+}
+
+uint64_t ExternalBitVector::Select(uint64_t i) const {
+    // same answer as BitVector for a vector without ones.
+    if (n_ones_ == 0) return 32;
+
+    if (i >= n_ones_)
+        throw std::runtime_error("Select index is out of range.");
+
+    // find the last chunk starting with less than i + 1 ones, between the samples.
+    uint64_t lo = s_[i / (64 * 64)];
+    uint64_t hi = i / (64 * 64) + 1 < s_.size() ? s_[i / (64 * 64) + 1] : r2_.size() - 1;
+
+    while (lo < hi) {
+        uint64_t mid = (lo + hi + 1) / 2;
+
+        if (RankChunk(mid) <= i)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    uint64_t rest = i - RankChunk(lo);
+    uint64_t w = lo * (kChunkBits / 32);
+    Page page = GetPage(w / page_words_);
+    const uint32_t *words = page->data();
+    size_t k = w % page_words_;
+
+    while (true) {
+        uint64_t count = _mm_popcnt_u32(words[k]);
+        if (rest < count) break;
+        rest -= count;
+        ++k;
+    }
+
+    return (w - w % page_words_ + k) * 32 + BitVector::SelectOn32bits(words[k], rest);
+}
+
+size_t ExternalBitVector::n_bytes() const {
+    size_t n = r1_.capacity() * sizeof(uint64_t) + r2_.capacity() * sizeof(uint16_t)
+               + s_.capacity() * sizeof(uint64_t);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return n + lru_.size() * page_size_;
+}
+
+void ExternalBitVector::Write(const std::string &path, const std::vector<bool> &v) {
+    std::vector<uint32_t> words((v.size() + 31) / 32, 0);
+
+    for (size_t i = 0; i < v.size(); ++i)
+        if (v[i]) words[i / 32] |= 1u << (31 - i % 32);
+
+    FILE *file = fopen(path.c_str(), "wb");
+
+    if (file == nullptr) {
+        throw std::runtime_error("Could not open " + path + ".");
+    }
+
+    size_t written = fwrite(words.data(), sizeof(uint32_t), words.size(), file);
+    fclose(file);
+
+    if (written != words.size())
+        throw std::runtime_error("Could not write bit vector.");
+}
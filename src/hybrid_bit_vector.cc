@@ -0,0 +1,250 @@
+#include "hybrid_bit_vector.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <nmmintrin.h>
+
+#include "bit_vector.h"
+
+using namespace succinct_bv;
+
+namespace {
+    const uint32_t kChunkWords = HybridBitVector::kChunkBits / 32;
+    // bitmap chunks store #ones at every 512 bits.
+    const uint32_t kBitmapRankWords = 512 / 32;
+}
+
+template<class T>
+void HybridBitVector::Init(const T &v) {
+    if (v.empty()) {
+        throw std::runtime_error("Given container is empty.");
+    }
+
+    n_ = v.size();
+    uint64_t n_chunks = (n_ - 1) / kChunkBits + 1;
+    chunks_.clear();
+    chunks_.reserve(n_chunks);
+    cumsums_.assign(1, 0);
+    cumsums_.reserve(n_chunks + 1);
+    values_.clear();
+    bitmaps_.clear();
+    bitmap_ranks_.clear();
+
+    std::vector<uint32_t> bits(kChunkWords);
+
+    for (uint64_t start = 0; start < n_; start += kChunkBits) {
+        uint64_t end = std::min(n_, start + kChunkBits);
+        std::fill(bits.begin(), bits.end(), 0);
+        uint32_t n_ones = 0;
+        uint32_t n_runs = 0;
+        bool previous = false;
+
+        for (uint64_t x = start; x < end; ++x) {
+            bool bit = v[x];
+
+            if (bit) {
+                bits[(x - start) / 32] |= 1u << (31 - (x - start) % 32);
+                ++n_ones;
+                if (!previous) ++n_runs;
+            }
+
+            previous = bit;
+        }
+
+        AddChunk(bits.data(), n_ones, n_runs);
+    }
+
+    // values and bitmaps grow by doubling because the container types are known only at the end.
+    values_.shrink_to_fit();
+    bitmaps_.shrink_to_fit();
+    bitmap_ranks_.shrink_to_fit();
+}
+
+template void HybridBitVector::Init<std::deque<bool> >(
+const std::deque<bool> &v);
+
+template void HybridBitVector::Init<std::vector<bool> >(
+const std::vector<bool> &v);
+
+void HybridBitVector::AddChunk(const uint32_t *bits, uint32_t n_ones, uint32_t n_runs) {
+    // sizes in bytes of each representation.
+    size_t array_bytes = n_ones * sizeof(uint16_t);
+    size_t run_bytes = n_runs * 3 * sizeof(uint16_t);
+    size_t bitmap_bytes = kChunkWords * sizeof(uint32_t)
+                          + kChunkWords / kBitmapRankWords * sizeof(uint16_t);
+    Chunk chunk;
+
+    if (array_bytes <= run_bytes && array_bytes <= bitmap_bytes) {
+        chunk = {values_.size(), n_ones, kArray};
+
+        for (uint32_t y = 0; y < kChunkBits; ++y)
+            if ((bits[y / 32] >> (31 - y % 32)) & 1u) values_.push_back(static_cast<uint16_t>(y));
+    } else if (run_bytes <= bitmap_bytes) {
+        chunk = {values_.size(), n_runs, kRun};
+        uint32_t before = 0;
+
+        for (uint32_t y = 0; y < kChunkBits;) {
+            if (((bits[y / 32] >> (31 - y % 32)) & 1u) == 0) {
+                ++y;
+                continue;
+            }
+
+            uint32_t first = y;
+
+            while (y < kChunkBits && ((bits[y / 32] >> (31 - y % 32)) & 1u))
+                ++y;
+
+            values_.push_back(static_cast<uint16_t>(first));
+            values_.push_back(static_cast<uint16_t>(y - 1));
+            // #ones before a run is at most its first position.
+            values_.push_back(static_cast<uint16_t>(before));
+            before += y - first;
+        }
+    } else {
+        chunk = {bitmaps_.size(), 0, kBitmap};
+        uint32_t sum = 0;
+
+        for (uint32_t w = 0; w < kChunkWords; ++w) {
+            if (w % kBitmapRankWords == 0)
+                bitmap_ranks_.push_back(static_cast<uint16_t>(sum));
+
+            bitmaps_.push_back(bits[w]);
+            sum += _mm_popcnt_u32(bits[w]);
+        }
+    }
+
+    chunks_.push_back(chunk);
+    cumsums_.push_back(cumsums_.back() + n_ones);
+}
+
+uint32_t HybridBitVector::FindRun(const Chunk &chunk, uint32_t y) const {
+    const uint16_t *runs = &values_[chunk.offset];
+    uint32_t lo = 0;
+    uint32_t hi = chunk.size;
+
+    // the first run starting after y.
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+
+        if (runs[3 * mid] <= y)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo == 0 ? chunk.size : lo - 1;
+}
+
+uint64_t HybridBitVector::RankInChunk(const Chunk &chunk, uint32_t y) const {
+    switch (chunk.type) {
+        case kArray: {
+            const uint16_t *values = &values_[chunk.offset];
+            return std::upper_bound(values, values + chunk.size, y) - values;
+        }
+        case kRun: {
+            uint32_t r = FindRun(chunk, y);
+            if (r == chunk.size) return 0;
+            const uint16_t *run = &values_[chunk.offset + 3 * r];
+            return run[2] + std::min<uint32_t>(y, run[1]) - run[0] + 1;
+        }
+        default: {
+            const uint32_t *words = &bitmaps_[chunk.offset];
+            uint32_t w = y / 32;
+            uint64_t r = bitmap_ranks_[chunk.offset / kBitmapRankWords + w / kBitmapRankWords];
+
+            for (uint32_t j = w - w % kBitmapRankWords; j < w; ++j)
+                r += _mm_popcnt_u32(words[j]);
+
+            return r + _mm_popcnt_u32(words[w] >> (31 - y % 32));
+        }
+    }
+}
+
+uint32_t HybridBitVector::SelectInChunk(const Chunk &chunk, uint32_t i) const {
+    switch (chunk.type) {
+        case kArray:
+            return values_[chunk.offset + i];
+        case kRun: {
+            const uint16_t *runs = &values_[chunk.offset];
+            uint32_t lo = 0;
+            uint32_t hi = chunk.size - 1;
+
+            // the last run with at most i ones before it.
+            while (lo < hi) {
+                uint32_t mid = (lo + hi + 1) / 2;
+
+                if (runs[3 * mid + 2] <= i)
+                    lo = mid;
+                else
+                    hi = mid - 1;
+            }
+
+            return runs[3 * lo] + i - runs[3 * lo + 2];
+        }
+        default: {
+            const uint16_t *ranks = &bitmap_ranks_[chunk.offset / kBitmapRankWords];
+            uint32_t n_ranks = kChunkWords / kBitmapRankWords;
+            uint32_t k = static_cast<uint32_t>(
+                    std::upper_bound(ranks, ranks + n_ranks, i) - ranks - 1);
+            const uint32_t *words = &bitmaps_[chunk.offset];
+            uint32_t w = k * kBitmapRankWords;
+            uint32_t rest = i - ranks[k];
+
+            while (true) {
+                uint32_t count = _mm_popcnt_u32(words[w]);
+                if (rest < count) break;
+                rest -= count;
+                ++w;
+            }
+
+            return w * 32 + BitVector::SelectOn32bits(words[w], static_cast<uint8_t>(rest));
+        }
+    }
+}
+
+bool HybridBitVector::At(uint64_t x) const {
+    if (chunks_.empty()) throw std::runtime_error("Bitvector is empty.");
+    const Chunk &chunk = chunks_[x / kChunkBits];
+    uint32_t y = static_cast<uint32_t>(x % kChunkBits);
+
+    switch (chunk.type) {
+        case kArray: {
+            const uint16_t *values = &values_[chunk.offset];
+            return std::binary_search(values, values + chunk.size, y);
+        }
+        case kRun: {
+            uint32_t r = FindRun(chunk, y);
+            return r != chunk.size && y <= values_[chunk.offset + 3 * r + 1];
+        }
+        default:
+            return (bitmaps_[chunk.offset + y / 32] >> (31 - y % 32)) & 1u;
+    }
+}
+
+uint64_t HybridBitVector::Rank(uint64_t x) const {
+    if (chunks_.empty()) throw std::runtime_error("Bitvector is empty.");
+    uint64_t c = x / kChunkBits;
+    return cumsums_[c] + RankInChunk(chunks_[c], static_cast<uint32_t>(x % kChunkBits));
+}
+
+uint64_t HybridBitVector::Select(uint64_t i) const {
+    if (chunks_.empty()) throw std::runtime_error("Bitvector is empty.");
+    // same answer as BitVector for a vector without ones.
+    if (cumsums_.back() == 0) return 32;
+
+    // the last chunk with at most i ones before it and at least one one.
+    uint64_t c = std::upper_bound(cumsums_.begin(), cumsums_.end(), i) - cumsums_.begin() - 1;
+    return c * kChunkBits + SelectInChunk(chunks_[c], static_cast<uint32_t>(i - cumsums_[c]));
+}
+
+size_t HybridBitVector::n_bytes() const {
+    return chunks_.capacity() * sizeof(Chunk) + cumsums_.capacity() * sizeof(uint64_t)
+           + values_.capacity() * sizeof(uint16_t) + bitmaps_.capacity() * sizeof(uint32_t)
+           + bitmap_ranks_.capacity() * sizeof(uint16_t);
+}
+
+size_t HybridBitVector::Count(Type type) const {
+    return std::count_if(chunks_.begin(), chunks_.end(),
+                         [type](const Chunk &chunk) { return chunk.type == type; });
+}
@@ -0,0 +1,193 @@
+#include "packed_symbol_vector.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <nmmintrin.h>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#define posix_memalign(p, a, s) (((*(p)) = _aligned_malloc((s), (a))), *(p) ?0 :errno)
+#endif
+
+using namespace succinct_bv;
+
+namespace {
+    void FreeLines(uint64_t *lines) {
+#ifdef _MSC_VER
+        _aligned_free(lines);
+#else
+        free(lines);
+#endif
+    }
+
+    // a word with the lowest bit of every kBits-bit field set.
+    template<int kBits>
+    constexpr uint64_t LowBits() {
+        return kBits == 2 ? 0x5555555555555555ULL : 0x1111111111111111ULL;
+    }
+
+    /**
+     For each m, the lowest bit of every field among the first m symbols of the data words of a line.
+     A row is one cache line, so Rank reads the masks instead of computing them from m.
+     */
+    template<int kBits>
+    class MaskTable {
+    public:
+        using Line = PackedSymbolVector<kBits>;
+
+        MaskTable() {
+            for (uint64_t m = 1; m <= Line::kSymbolsPerLine; ++m) {
+                for (uint64_t k = 0; k < 8; ++k) {
+                    uint64_t first = k * Line::kSymbolsPerWord;
+                    uint64_t bits = m <= first ? 0 : std::min(m - first, Line::kSymbolsPerWord) * kBits;
+                    rows_[m - 1].masks[k] = bits == 64 ? LowBits<kBits>()
+                                                       : LowBits<kBits>() & ((uint64_t(1) << bits) - 1);
+                }
+            }
+        }
+
+        const uint64_t *Row(uint64_t m) const { return rows_[m - 1].masks; }
+
+    private:
+        struct alignas(64) Row_ {
+            uint64_t masks[8];
+        };
+
+        Row_ rows_[Line::kSymbolsPerLine];
+    };
+
+    const MaskTable<2> maskTable2 = MaskTable<2>();
+    const MaskTable<4> maskTable4 = MaskTable<4>();
+
+    template<int kBits>
+    const uint64_t *Masks(uint64_t m) {
+        return kBits == 2 ? maskTable2.Row(m) : maskTable4.Row(m);
+    }
+}
+
+template<int kBits>
+void PackedSymbolVector<kBits>::Init(const std::vector<uint8_t> &v) {
+    if (v.empty()) {
+        throw std::runtime_error("Given container is empty.");
+    }
+
+    n_ = v.size();
+    // one more line as n_b_ in BitVector, so that Rank never reads past the last line.
+    n_lines_ = n_ / kSymbolsPerLine + 1;
+    uint64_t *lines = nullptr;
+    posix_memalign((void **) &lines, 64, n_lines_ * 8 * sizeof(uint64_t));
+
+    if (lines == nullptr)
+        throw std::runtime_error("Could not allocate memory for symbols.");
+
+    lines_ = std::shared_ptr<const uint64_t>(lines, FreeLines);
+    r1_.assign(((n_lines_ - 1) / kLinesPerSuperblock + 1) * kSigma, 0);
+
+    std::array<uint64_t, kSigma> total = {};
+    std::array<uint64_t, kSigma> in_superblock = {};
+
+    for (uint64_t line = 0; line < n_lines_; ++line) {
+        uint64_t *words = lines + line * 8;
+
+        if (line % kLinesPerSuperblock == 0) {
+            for (uint64_t c = 0; c < kSigma; ++c)
+                r1_[line / kLinesPerSuperblock * kSigma + c] = total[c];
+            in_superblock.fill(0);
+        }
+
+        for (uint64_t k = 0; k < kCountWords; ++k) {
+            words[k] = 0;
+
+            for (uint64_t j = 0; j < 4; ++j)
+                words[k] |= in_superblock[k * 4 + j] << (16 * j);
+        }
+
+        for (uint64_t k = kCountWords; k < 8; ++k)
+            words[k] = 0;
+
+        uint64_t first = line * kSymbolsPerLine;
+
+        for (uint64_t x = first; x < std::min(n_, first + kSymbolsPerLine); ++x) {
+            uint8_t c = v[x] & (kSigma - 1);
+            uint64_t y = x - first;
+            words[kCountWords + y / kSymbolsPerWord] |= uint64_t(c) << (y % kSymbolsPerWord * kBits);
+            ++total[c];
+            ++in_superblock[c];
+        }
+    }
+}
+
+template<int kBits>
+uint64_t PackedSymbolVector<kBits>::CountInLine(const uint64_t *words, uint8_t c, uint64_t m) {
+    uint64_t pattern = ~(LowBits<kBits>() * c);
+    const uint64_t *masks = Masks<kBits>(m);
+    uint64_t r = 0;
+
+    // every word is counted with a mask instead of a loop bounded by m,
+    // so that no branch depends on the position and misses of consecutive queries overlap.
+    for (uint64_t k = 0; k < kDataWords; ++k) {
+        // a field is all ones after xor with the complement of c iff the symbol is c.
+        uint64_t t = words[k] ^ pattern;
+
+        for (int s = 1; s < kBits; s *= 2)
+            t &= t >> s;
+
+        r += _mm_popcnt_u64(t & masks[k]);
+    }
+
+    return r;
+}
+
+template<int kBits>
+uint8_t PackedSymbolVector<kBits>::At(uint64_t x) const {
+    if (lines_ == nullptr) throw std::runtime_error("Bitvector is empty.");
+
+    const uint64_t *words = lines_.get() + x / kSymbolsPerLine * 8 + kCountWords;
+    uint64_t y = x % kSymbolsPerLine;
+    return (words[y / kSymbolsPerWord] >> (y % kSymbolsPerWord * kBits)) & (kSigma - 1);
+}
+
+template<int kBits>
+uint64_t PackedSymbolVector<kBits>::Rank(uint8_t c, uint64_t x) const {
+    if (lines_ == nullptr) throw std::runtime_error("Bitvector is empty.");
+    if (c >= kSigma) throw std::runtime_error("Symbol is out of range.");
+
+    uint64_t line = x / kSymbolsPerLine;
+    const uint64_t *words = lines_.get() + line * 8;
+    uint64_t m = x % kSymbolsPerLine + 1;
+
+    return r1_[line / kLinesPerSuperblock * kSigma + c] + ((words[c / 4] >> (16 * (c % 4))) & 0xffff)
+           + CountInLine(words + kCountWords, c, m);
+}
+
+template<int kBits>
+std::array<uint64_t, PackedSymbolVector<kBits>::kSigma> PackedSymbolVector<kBits>::RankAll(
+        uint64_t x) const {
+    if (lines_ == nullptr) throw std::runtime_error("Bitvector is empty.");
+
+    uint64_t line = x / kSymbolsPerLine;
+    const uint64_t *words = lines_.get() + line * 8;
+    const uint64_t *r1 = r1_.data() + line / kLinesPerSuperblock * kSigma;
+    uint64_t m = x % kSymbolsPerLine + 1;
+    std::array<uint64_t, kSigma> r;
+    uint64_t sum = 0;
+
+    // the last symbol is counted as the rest of [line start..x].
+    for (uint64_t c = 0; c + 1 < kSigma; ++c) {
+        r[c] = r1[c] + ((words[c / 4] >> (16 * (c % 4))) & 0xffff)
+               + CountInLine(words + kCountWords, c, m);
+        sum += r[c];
+    }
+
+    r[kSigma - 1] = x + 1 - sum;
+    return r;
+}
+
+template<int kBits>
+size_t PackedSymbolVector<kBits>::n_bytes() const {
+    return n_lines_ * 8 * sizeof(uint64_t) + r1_.capacity() * sizeof(uint64_t);
+}
+
+template class succinct_bv::PackedSymbolVector<2>;
+template class succinct_bv::PackedSymbolVector<4>;
@@ -0,0 +1,204 @@
+#include "query_executor.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace succinct_bv;
+
+QueryExecutor::QueryExecutor(size_t n_threads) {
+    n_threads = std::max<size_t>(1, n_threads);
+
+    for (size_t w = 0; w < n_threads; ++w)
+        queues_.push_back(std::make_unique<Queue>());
+
+    for (size_t w = 1; w < n_threads; ++w)
+        threads_.emplace_back(&QueryExecutor::Loop, this, w);
+}
+
+QueryExecutor::~QueryExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+
+    wake_.notify_all();
+
+    for (auto &thread : threads_)
+        thread.join();
+}
+
+void QueryExecutor::Run(size_t n_tasks, const std::function<void(size_t)> &job) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // a worker woken late for the previous job may still be looking for tasks.
+        done_.wait(lock, [this]() { return active_ == 0; });
+        size_t n = queues_.size();
+
+        for (size_t w = 0; w < n; ++w) {
+            std::lock_guard<std::mutex> queue_lock(queues_[w]->mutex);
+
+            for (size_t t = w * n_tasks / n; t < (w + 1) * n_tasks / n; ++t)
+                queues_[w]->tasks.push_back(t);
+        }
+
+        remaining_ = n_tasks;
+        job_ = &job;
+        ++generation_;
+    }
+
+    wake_.notify_all();
+    Work(0, job);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return remaining_ == 0; });
+}
+
+void QueryExecutor::Loop(size_t worker) {
+    uint64_t seen = 0;
+
+    while (true) {
+        const std::function<void(size_t)> *job;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            job = job_;
+            ++active_;
+        }
+
+        Work(worker, *job);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --active_;
+        }
+
+        done_.notify_all();
+    }
+}
+
+void QueryExecutor::Work(size_t worker, const std::function<void(size_t)> &job) {
+    size_t task;
+
+    while (Pop(worker, task)) {
+        job(task);
+
+        if (--remaining_ == 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_.notify_all();
+        }
+    }
+}
+
+bool QueryExecutor::Pop(size_t worker, size_t &task) {
+    for (size_t k = 0; k < queues_.size(); ++k) {
+        Queue &queue = *queues_[(worker + k) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.tasks.empty()) continue;
+
+        if (k == 0) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+        } else {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+std::vector<uint64_t> QueryExecutor::Execute(const BitVector &bv,
+                                             const std::vector<Query> &queries) {
+    std::vector<uint64_t> answers(queries.size());
+
+    if (queries.empty()) return answers;
+
+    if (bv.size() == 0) throw std::runtime_error("Bitvector is empty.");
+
+    std::lock_guard<std::mutex> execute_lock(execute_mutex_);
+    // a block is w^2 bits for Rank and At, and w^2 ones for Select.
+    const uint64_t block = 64 * 64;
+    uint64_t n_keys[2] = {bv.size() / block + 1, bv.Rank(bv.size() - 1) / block + 1};
+    int shifts[2];
+    size_t n_regions[2];
+
+    for (int kind = 0; kind < 2; ++kind) {
+        shifts[kind] = 0;
+
+        while (uint64_t(1) << (shifts[kind] + 1) <= kBlocksPerRegion &&
+               n_keys[kind] >> (shifts[kind] + 1) >= kMinRegionsPerThread * n_threads())
+            ++shifts[kind];
+
+        n_regions[kind] = ((n_keys[kind] - 1) >> shifts[kind]) + 1;
+    }
+
+    size_t n_all = n_regions[0] + n_regions[1];
+
+    auto region = [&](const Query &q) -> size_t {
+        int kind = q.type == Query::kSelect;
+        uint64_t key = std::min(q.x / block, n_keys[kind] - 1);
+        return kind * n_regions[0] + (key >> shifts[kind]);
+    };
+
+    // bucket the queries by region in parallel: count, prefix sums, then scatter.
+    size_t n_slices = n_threads();
+    size_t slice = (queries.size() + n_slices - 1) / n_slices;
+    std::vector<size_t> offsets(n_slices * n_all, 0);
+
+    Run(n_slices, [&](size_t s) {
+        for (size_t k = s * slice, end = std::min(queries.size(), k + slice); k < end; ++k)
+            ++offsets[s * n_all + region(queries[k])];
+    });
+
+    std::vector<size_t> begins(n_all + 1);
+    size_t sum = 0;
+
+    for (size_t r = 0; r < n_all; ++r) {
+        begins[r] = sum;
+
+        for (size_t s = 0; s < n_slices; ++s) {
+            size_t count = offsets[s * n_all + r];
+            offsets[s * n_all + r] = sum;
+            sum += count;
+        }
+    }
+
+    begins[n_all] = sum;
+
+    // copies of the queries are read sequentially when answering.
+    struct Entry {
+        Query query;
+        size_t index;
+    };
+    std::vector<Entry> entries(queries.size());
+
+    Run(n_slices, [&](size_t s) {
+        for (size_t k = s * slice, end = std::min(queries.size(), k + slice); k < end; ++k)
+            entries[offsets[s * n_all + region(queries[k])]++] = {queries[k], k};
+    });
+
+    Run(n_all, [&](size_t r) {
+        for (size_t k = begins[r]; k < begins[r + 1]; ++k) {
+            const Query &q = entries[k].query;
+
+            switch (q.type) {
+                case Query::kAt:
+                    answers[entries[k].index] = bv.At(q.x);
+                    break;
+                case Query::kRank:
+                    answers[entries[k].index] = bv.Rank(q.x);
+                    break;
+                default:
+                    answers[entries[k].index] = bv.Select(q.x);
+            }
+        }
+    });
+
+    return answers;
+}
@@ -0,0 +1,150 @@
+#include "run_length_bit_vector.h"
+#include "bit_vector_builder.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace succinct_bv;
+
+template<class T>
+void RunLengthBitVector::Init(const T &v) {
+    if (v.empty()) {
+        throw std::runtime_error("Given container is empty.");
+    }
+
+    n_ = v.size();
+    starts_.clear();
+    cumsums_.clear();
+    uint64_t count = 0;
+    bool previous = false;
+
+    for (uint64_t x = 0; x < n_; ++x) {
+        bool bit = v[x];
+
+        if (bit) {
+            if (!previous) {
+                starts_.push_back(x);
+                cumsums_.push_back(count);
+            }
+
+            ++count;
+        }
+
+        previous = bit;
+    }
+
+    cumsums_.push_back(count);
+    starts_.shrink_to_fit();
+    cumsums_.shrink_to_fit();
+}
+
+template void RunLengthBitVector::Init<std::deque<bool> >(
+const std::deque<bool> &v);
+
+template void RunLengthBitVector::Init<std::vector<bool> >(
+const std::vector<bool> &v);
+
+RunLengthBitVector::RunLengthBitVector(const BitVector &bv) : n_(bv.size()) {
+    if (n_ == 0) {
+        throw std::runtime_error("Bitvector is empty.");
+    }
+
+    uint64_t n_ones = bv.Rank(n_ - 1);
+    uint64_t count = 0;
+
+    while (count < n_ones) {
+        uint64_t start = bv.Select(count);
+        // the run is [start, start + length) if every bit in it is one.
+        // grow the length exponentially, then binary search the end.
+        uint64_t lo = 1;
+        uint64_t hi = 1;
+
+        while (start + hi <= n_ && bv.Rank(start + hi - 1) - count == hi) {
+            lo = hi;
+            hi *= 2;
+        }
+
+        hi = std::min(hi, n_ - start + 1);
+
+        while (hi - lo > 1) {
+            uint64_t mid = lo + (hi - lo) / 2;
+
+            if (bv.Rank(start + mid - 1) - count == mid)
+                lo = mid;
+            else
+                hi = mid;
+        }
+
+        starts_.push_back(start);
+        cumsums_.push_back(count);
+        count += lo;
+    }
+
+    cumsums_.push_back(count);
+}
+
+size_t RunLengthBitVector::FindRun(uint64_t x) const {
+    size_t r = std::upper_bound(starts_.begin(), starts_.end(), x) - starts_.begin();
+    return r == 0 ? starts_.size() : r - 1;
+}
+
+bool RunLengthBitVector::At(uint64_t x) const {
+    if (n_ == 0) throw std::runtime_error("Bitvector is empty.");
+    size_t r = FindRun(x);
+    return r != starts_.size() && x - starts_[r] < Length(r);
+}
+
+uint64_t RunLengthBitVector::Rank(uint64_t x) const {
+    if (n_ == 0) throw std::runtime_error("Bitvector is empty.");
+    size_t r = FindRun(x);
+    if (r == starts_.size()) return 0;
+    return cumsums_[r] + std::min(x - starts_[r] + 1, Length(r));
+}
+
+uint64_t RunLengthBitVector::Select(uint64_t i) const {
+    if (n_ == 0) throw std::runtime_error("Bitvector is empty.");
+    // same answer as BitVector for a vector without ones.
+    if (starts_.empty()) return 32;
+
+    // the last run with at most i ones before it.
+    size_t r = std::upper_bound(cumsums_.begin(), cumsums_.end() - 1, i) - cumsums_.begin() - 1;
+    return starts_[r] + i - cumsums_[r];
+}
+
+uint64_t RunLengthBitVector::Select0(uint64_t i) const {
+    if (n_ == 0) throw std::runtime_error("Bitvector is empty.");
+    // #zeros before run r is starts_[r] - cumsums_[r], which never decreases.
+    // the i-th zero follows the last run with at most i zeros before it.
+    size_t lo = 0;
+    size_t hi = starts_.size();
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (starts_[mid] - cumsums_[mid] <= i)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo == 0 ? i : i + cumsums_[lo];
+}
+
+BitVector RunLengthBitVector::ToBitVector() const {
+    if (n_ == 0) throw std::runtime_error("Bitvector is empty.");
+    BitVectorBuilder builder(n_);
+    uint64_t x = 0;
+
+    for (size_t r = 0; r < starts_.size(); ++r) {
+        for (; x < starts_[r]; ++x)
+            builder.PushBack(false);
+
+        for (uint64_t end = starts_[r] + Length(r); x < end; ++x)
+            builder.PushBack(true);
+    }
+
+    for (; x < n_; ++x)
+        builder.PushBack(false);
+
+    return builder.Build();
+}
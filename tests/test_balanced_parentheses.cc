@@ -0,0 +1,121 @@
+#include "balanced_parentheses.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace succinct_bv {
+
+class BalancedParenthesesTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    // a random tree, and a path deep enough to cross many blocks.
+    v1_ = RandomTree(300000);
+    v2_ = std::vector<bool>(20000, true);
+    v2_.resize(40000, false);
+
+    for (auto &v : {v1_, v2_}) {
+      std::vector<uint64_t> stack;
+      std::vector<uint64_t> close(v.size(), BalancedParentheses::npos);
+      std::vector<uint64_t> open(v.size(), BalancedParentheses::npos);
+      std::vector<uint64_t> parent(v.size(), BalancedParentheses::npos);
+
+      for (uint64_t i = 0; i < v.size(); ++i) {
+        if (v[i]) {
+          if (!stack.empty()) parent[i] = stack.back();
+          stack.push_back(i);
+        } else {
+          close[stack.back()] = i;
+          open[i] = stack.back();
+          stack.pop_back();
+        }
+      }
+
+      closes_.push_back(close);
+      opens_.push_back(open);
+      parents_.push_back(parent);
+    }
+  }
+
+  static std::vector<bool> RandomTree(uint64_t n_nodes) {
+    std::vector<bool> v;
+    uint64_t opens = 0;
+    uint64_t depth = 0;
+
+    while (v.size() < 2 * n_nodes) {
+      bool open = opens < n_nodes && (depth == 0 || rand() % (2 * n_nodes - v.size()) < n_nodes - opens);
+      v.push_back(open);
+      if (open) ++opens, ++depth;
+      else --depth;
+    }
+
+    return v;
+  }
+
+  static std::vector<bool> Parse(const std::string &s) {
+    std::vector<bool> v;
+
+    for (char c : s)
+      v.push_back(c == '(');
+
+    return v;
+  }
+
+  std::vector<bool> v1_;
+  std::vector<bool> v2_;
+  std::vector<std::vector<uint64_t> > closes_;
+  std::vector<std::vector<uint64_t> > opens_;
+  std::vector<std::vector<uint64_t> > parents_;
+};
+
+TEST_F(BalancedParenthesesTest, SmallTreeWorks) {
+  // 0: root, children 1, 9, 11. 1 has children 2 and 4, 4 has child 5.
+  BalancedParentheses bp(Parse("((()(()))()())"));
+
+  EXPECT_EQ(13u, bp.FindClose(0));
+  EXPECT_EQ(8u, bp.FindClose(1));
+  EXPECT_EQ(3u, bp.FindClose(2));
+  EXPECT_EQ(0u, bp.FindOpen(13));
+  EXPECT_EQ(4u, bp.FindOpen(7));
+  EXPECT_EQ(BalancedParentheses::npos, bp.Enclose(0));
+  EXPECT_EQ(0u, bp.Parent(1));
+  EXPECT_EQ(4u, bp.Parent(5));
+  EXPECT_EQ(1u, bp.FirstChild(0));
+  EXPECT_EQ(BalancedParentheses::npos, bp.FirstChild(2));
+  EXPECT_EQ(9u, bp.NextSibling(1));
+  EXPECT_EQ(BalancedParentheses::npos, bp.NextSibling(11));
+  EXPECT_EQ(7u, bp.SubtreeSize(0));
+  EXPECT_EQ(4u, bp.SubtreeSize(1));
+  EXPECT_EQ(1u, bp.SubtreeSize(9));
+  EXPECT_EQ(0u, bp.Depth(0));
+  EXPECT_EQ(3u, bp.Depth(5));
+
+  EXPECT_THROW(BalancedParentheses(std::vector<bool>()), std::runtime_error);
+}
+
+TEST_F(BalancedParenthesesTest, LargeTreesWork) {
+  int k = 0;
+
+  for (auto &v : {v1_, v2_}) {
+    BalancedParentheses bp(v);
+    ASSERT_EQ(v.size(), bp.size());
+
+    for (uint64_t i = 0; i < v.size(); ++i) {
+      if (v[i]) {
+        uint64_t close = closes_[k][i];
+        EXPECT_EQ(close, bp.FindClose(i));
+        EXPECT_EQ(parents_[k][i], bp.Enclose(i));
+        EXPECT_EQ((close - i + 1) / 2, bp.SubtreeSize(i));
+        EXPECT_EQ(close + 1 < v.size() && v[close + 1] ? close + 1 : BalancedParentheses::npos,
+                  bp.NextSibling(i));
+      } else {
+        EXPECT_EQ(opens_[k][i], bp.FindOpen(i));
+      }
+    }
+
+    ++k;
+  }
+}
+
+} // namespace succinct_bv
@@ -1,5 +1,6 @@
 #include "bit_vector.h"
 
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -25,7 +26,7 @@ class BitVectorTest : public ::testing::Test {
     v3_.resize(1000000, false);
     n_true_ = 0;
 
-    for (int i = 0; i < v3_.size(); ++i) {
+    for (size_t i = 0; i < v3_.size(); ++i) {
       if (rand() % 2 == 0) {
         ++n_true_;
         v3_[i] = true;
@@ -35,7 +36,7 @@ class BitVectorTest : public ::testing::Test {
     v4_.resize(1000000, false);
     n_sparse_true_ = 0;
 
-    for (int i = 0; i < v4_.size(); ++i) {
+    for (size_t i = 0; i < v4_.size(); ++i) {
       if (rand() % 1000 == 0) {
         ++n_sparse_true_;
         v4_[i] = true;
@@ -46,7 +47,7 @@ class BitVectorTest : public ::testing::Test {
     n_mix_true_ = 0;
     bool sparse_mode = true;
 
-    for (int i = 0; i < v5_.size(); ++i) {
+    for (size_t i = 0; i < v5_.size(); ++i) {
       if (i % 10000 == 0) sparse_mode = !sparse_mode;
 
       if (sparse_mode && rand() % 1000 == 0) {
@@ -109,7 +110,7 @@ TEST_F(BitVectorTest, AssignWorks) {
         EXPECT_EQ(0, bv3.Rank(0));
         EXPECT_EQ(0, bv3.Rank(1));
     }
-    catch (std::runtime_error) {
+    catch (const std::runtime_error &) {
         EXPECT_EQ(0,0);
     }
     bv3 = v2_;
@@ -117,6 +118,44 @@ TEST_F(BitVectorTest, AssignWorks) {
     EXPECT_EQ(831u, bv3.Select(1));
 }
 
+TEST_F(BitVectorTest, CopyWorks) {
+    BitVector bv1(v2_);
+    BitVector bv2(bv1);
+    bv1 = v1_;
+    EXPECT_EQ(0, bv1.Select(0));
+    EXPECT_EQ(111u, bv2.Select(0));
+    EXPECT_EQ(3u, bv2.Rank(9999));
+
+    BitVector bv3(std::move(bv2));
+    EXPECT_EQ(831u, bv3.Select(1));
+    swap(bv1, bv3);
+    EXPECT_EQ(831u, bv1.Select(1));
+    EXPECT_EQ(2, bv3.Select(1));
+}
+
+TEST_F(BitVectorTest, ConcurrentCopiesWork) {
+    BitVector bv(v3_);
+    NaiveBitVector nbv(v3_);
+    std::vector<std::thread> threads;
+    std::vector<int> n_errors(4, 0);
+
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = t; i < n_true_; i += 997) {
+                BitVector copy = bv;
+                if (copy.Select(i) != nbv.Select(i) || copy.Rank(i) != nbv.Rank(i))
+                    ++n_errors[t];
+            }
+        });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    for (int t = 0; t < 4; ++t)
+        EXPECT_EQ(0, n_errors[t]);
+}
+
 TEST_F(BitVectorTest, AtWorks) {
     BitVector bv1(v1_);
     EXPECT_EQ(true,bv1.At(0));
@@ -168,19 +207,19 @@ TEST_F(BitVectorTest, RankWorks) {
   BitVector bv3(v3_);
   NaiveBitVector nbv3(v3_);
 
-  for (int i = 0; i < v3_.size(); ++i)
+  for (size_t i = 0; i < v3_.size(); ++i)
     EXPECT_EQ(nbv3.Rank(i), bv3.Rank(i));
 
   BitVector bv4(v4_);
   NaiveBitVector nbv4(v4_);
 
-  for (int i = 0; i < v4_.size(); ++i)
+  for (size_t i = 0; i < v4_.size(); ++i)
     EXPECT_EQ(nbv4.Rank(i), bv4.Rank(i));
 
   BitVector bv5(v5_);
   NaiveBitVector nbv5(v5_);
 
-  for (int i = 0; i < v5_.size(); ++i)
+  for (size_t i = 0; i < v5_.size(); ++i)
     EXPECT_EQ(nbv5.Rank(i), bv5.Rank(i));
 }
 
@@ -219,4 +258,35 @@ TEST_F(BitVectorTest, SelectWorks) {
     EXPECT_EQ(nbv5.Select(i), bv5.Select(i));
 }
 
+TEST_F(BitVectorTest, SelectMixedDensityWorks) {
+  // every 1 << 16 bits switch density so that blocks use the array, the tree and the samples.
+  std::vector<bool> v(1 << 22, false);
+  const int periods[] = {1, 2, 3, 8, 64, 1000};
+
+  for (size_t i = 0; i < v.size(); ++i) {
+    int period = periods[(i >> 16) % 6];
+    v[i] = rand() % period == 0;
+  }
+
+  BitVector bv(v);
+  NaiveBitVector nbv(v);
+
+  for (uint64_t i = 0, n = nbv.Rank(v.size() - 1); i < n; ++i)
+    EXPECT_EQ(nbv.Select(i), bv.Select(i));
+}
+
+TEST_F(BitVectorTest, SparseSelectIndexIsSmall) {
+  // 100 ones over 2^26 bits make one select block stored as an array of 100 positions.
+  std::vector<bool> v(1 << 26, false);
+  BitVector empty(v);
+
+  for (size_t i = 0; i < 100; ++i)
+    v[i * (v.size() / 100)] = true;
+
+  BitVector bv(v);
+
+  EXPECT_EQ(v.size() / 100 * 99, bv.Select(99));
+  EXPECT_LE(bv.n_bytes(), empty.n_bytes() + 100 * sizeof(uint64_t) + 64);
+}
+
 } // namespace succinct_bv
@@ -0,0 +1,126 @@
+#include "bit_vector_builder.h"
+
+#include <cstdio>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "bit_vector.h"
+
+namespace succinct_bv {
+
+class BitVectorBuilderTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    v1_.resize(1000000, false);
+
+    for (size_t i = 0; i < v1_.size(); ++i) {
+      int period = (i >> 16) % 2 == 0 ? 2 : 1000;
+      v1_[i] = rand() % period == 0;
+    }
+
+    words_.resize(v1_.size() / 32 + 1, 0);
+
+    for (size_t i = 0; i < v1_.size(); ++i)
+      if (v1_[i]) words_[i / 32] |= 1u << (31 - i % 32);
+  }
+
+  void ExpectSame(const BitVector &expected, const BitVector &actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    EXPECT_EQ(expected.n_bytes(), actual.n_bytes());
+
+    for (uint64_t x = 0; x < v1_.size(); ++x) {
+      EXPECT_EQ(expected.At(x), actual.At(x));
+      EXPECT_EQ(expected.Rank(x), actual.Rank(x));
+    }
+
+    for (uint64_t i = 0, n = expected.Rank(v1_.size() - 1); i < n; ++i)
+      EXPECT_EQ(expected.Select(i), actual.Select(i));
+  }
+
+  std::vector<bool> v1_;
+  std::vector<uint32_t> words_;
+};
+
+TEST_F(BitVectorBuilderTest, PushBackWorks) {
+  BitVectorBuilder builder;
+
+  for (bool bit : v1_)
+    builder.PushBack(bit);
+
+  EXPECT_EQ(v1_.size(), builder.size());
+  ExpectSame(BitVector(v1_), builder.Build());
+  EXPECT_EQ(0u, builder.size());
+  EXPECT_THROW(builder.Build(), std::runtime_error);
+}
+
+TEST_F(BitVectorBuilderTest, MoveWorks) {
+  EXPECT_FALSE(std::is_copy_constructible<BitVectorBuilder>::value);
+  EXPECT_FALSE(std::is_copy_assignable<BitVectorBuilder>::value);
+
+  BitVectorBuilder builder;
+
+  for (bool bit : v1_)
+    builder.PushBack(bit);
+
+  BitVectorBuilder moved(std::move(builder));
+  EXPECT_EQ(v1_.size(), moved.size());
+  ExpectSame(BitVector(v1_), moved.Build());
+}
+
+TEST_F(BitVectorBuilderTest, AppendWorks) {
+  // start unaligned so that words are split across two blocks.
+  std::vector<bool> v(3, true);
+  v.insert(v.end(), v1_.begin(), v1_.end() - v1_.size() % 32);
+  BitVectorBuilder builder(v.size());
+
+  for (int i = 0; i < 3; ++i)
+    builder.PushBack(true);
+
+  builder.Append(words_.data(), v1_.size() / 32);
+
+  BitVector bv = builder.Build();
+  BitVector expected(v);
+  ASSERT_EQ(v.size(), bv.size());
+
+  for (uint64_t x = 0; x < v.size(); ++x)
+    EXPECT_EQ(expected.Rank(x), bv.Rank(x));
+
+  for (uint64_t i = 0, n = expected.Rank(v.size() - 1); i < n; ++i)
+    EXPECT_EQ(expected.Select(i), bv.Select(i));
+}
+
+TEST_F(BitVectorBuilderTest, FromCallbackWorks) {
+  // the whole words only, so that the last word is complete.
+  size_t n_words = v1_.size() / 32;
+  size_t read = 0;
+  BitVector bv = BitVectorBuilder::FromCallback([&](uint32_t *words, size_t n) {
+    size_t k = 0;
+
+    for (; k < n && read < n_words; ++k, ++read)
+      words[k] = words_[read];
+
+    return k;
+  });
+
+  std::vector<bool> v(v1_.begin(), v1_.begin() + n_words * 32);
+  BitVector expected(v);
+  ASSERT_EQ(v.size(), bv.size());
+
+  for (uint64_t i = 0, n = expected.Rank(v.size() - 1); i < n; ++i)
+    EXPECT_EQ(expected.Select(i), bv.Select(i));
+}
+
+TEST_F(BitVectorBuilderTest, FromFdWorks) {
+  FILE *file = tmpfile();
+  ASSERT_NE(nullptr, file);
+  fwrite(words_.data(), sizeof(uint32_t), words_.size(), file);
+  fflush(file);
+  rewind(file);
+
+  ExpectSame(BitVector(v1_), BitVectorBuilder::FromFd(fileno(file), v1_.size()));
+  fclose(file);
+}
+
+} // namespace succinct_bv
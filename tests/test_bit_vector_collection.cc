@@ -0,0 +1,93 @@
+#include "bit_vector_collection.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "bit_vector.h"
+
+namespace succinct_bv {
+
+class BitVectorCollectionTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    for (int k = 0; k < 1000; ++k) {
+      std::vector<bool> v(100 + rand() % 3000, false);
+      int period = 1 + k % 7 * (k % 7);
+
+      for (size_t i = 0; i < v.size(); ++i)
+        v[i] = rand() % period == 0;
+
+      vs_.push_back(v);
+    }
+
+    vs_[10] = std::vector<bool>(500, false);
+    vs_[20] = std::vector<bool>(500, true);
+  }
+
+  std::vector<std::vector<bool> > vs_;
+};
+
+TEST_F(BitVectorCollectionTest, SizeWorks) {
+  BitVectorCollection c(vs_);
+
+  EXPECT_EQ(vs_.size(), c.size());
+
+  for (size_t k = 0; k < vs_.size(); ++k)
+    EXPECT_EQ(vs_[k].size(), c.Length(k));
+
+  EXPECT_EQ(0u, BitVectorCollection().size());
+}
+
+TEST_F(BitVectorCollectionTest, EmptyMembersWork) {
+  std::vector<std::deque<bool> > ds = {{}, {false, true, true}, {}, {true}};
+  BitVectorCollection c(ds);
+
+  EXPECT_EQ(0u, c.Length(0));
+  EXPECT_EQ(3u, c.Length(1));
+  EXPECT_EQ(2u, c.Rank(1, 2));
+  EXPECT_EQ(2u, c.Select(1, 1));
+  EXPECT_EQ(0u, c.Select(3, 0));
+  EXPECT_EQ(true, c.At(3, 0));
+
+  EXPECT_THROW(BitVectorCollection(std::vector<std::deque<bool> >(3)),
+               std::runtime_error);
+}
+
+TEST_F(BitVectorCollectionTest, InvalidMemberThrows) {
+  BitVectorCollection empty;
+  EXPECT_THROW(empty.At(0, 0), std::runtime_error);
+  EXPECT_THROW(empty.Rank(0, 0), std::runtime_error);
+  EXPECT_THROW(empty.Select(0, 0), std::runtime_error);
+  EXPECT_THROW(empty.Length(0), std::runtime_error);
+
+  BitVectorCollection c(vs_);
+  EXPECT_THROW(c.At(vs_.size(), 0), std::runtime_error);
+  EXPECT_THROW(c.Rank(vs_.size(), 0), std::runtime_error);
+  EXPECT_THROW(c.Select(vs_.size(), 0), std::runtime_error);
+  EXPECT_THROW(c.Length(vs_.size()), std::runtime_error);
+}
+
+TEST_F(BitVectorCollectionTest, QueriesMatchBitVector) {
+  BitVectorCollection c(vs_);
+
+  for (size_t k = 0; k < vs_.size(); ++k) {
+    BitVector bv(vs_[k]);
+    uint64_t n_ones = 0;
+
+    for (uint64_t x = 0; x < vs_[k].size(); ++x) {
+      EXPECT_EQ(bv.At(x), c.At(k, x));
+      EXPECT_EQ(bv.Rank(x), c.Rank(k, x));
+      if (vs_[k][x]) ++n_ones;
+    }
+
+    for (uint64_t i = 0; i < n_ones; ++i)
+      EXPECT_EQ(bv.Select(i), c.Select(k, i));
+
+    if (n_ones == 0) {
+      EXPECT_EQ(bv.Select(0), c.Select(k, 0));
+    }
+  }
+}
+
+} // namespace succinct_bv
@@ -0,0 +1,88 @@
+#include "external_bit_vector.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "bit_vector.h"
+
+namespace succinct_bv {
+
+class ExternalBitVectorTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    path_ = testing::TempDir() + "external_bit_vector_test.bin";
+
+    v1_.resize(1000003, false);
+
+    for (size_t i = 0; i < v1_.size(); ++i) {
+      int period = (i >> 16) % 3 == 0 ? 2 : ((i >> 16) % 3 == 1 ? 1000 : 7);
+      v1_[i] = rand() % period == 0;
+    }
+  }
+
+  virtual void TearDown() { std::remove(path_.c_str()); }
+
+  std::string path_;
+  std::vector<bool> v1_;
+};
+
+TEST_F(ExternalBitVectorTest, QueriesMatchBitVector) {
+  ExternalBitVector::Write(path_, v1_);
+  // a small cache so that pages are evicted.
+  ExternalBitVector ebv(path_, v1_.size(), 256, 4 * 256);
+  BitVector bv(v1_);
+
+  EXPECT_EQ(v1_.size(), ebv.size());
+
+  for (uint64_t x = 0; x < v1_.size(); x += 7) {
+    EXPECT_EQ(bv.At(x), ebv.At(x));
+    EXPECT_EQ(bv.Rank(x), ebv.Rank(x));
+  }
+
+  EXPECT_EQ(bv.Rank(v1_.size() - 1), ebv.Rank(v1_.size() - 1));
+
+  for (uint64_t i = 0, n = bv.Rank(v1_.size() - 1); i < n; ++i)
+    EXPECT_EQ(bv.Select(i), ebv.Select(i));
+
+  EXPECT_THROW(ebv.Select(bv.Rank(v1_.size() - 1)), std::runtime_error);
+}
+
+TEST_F(ExternalBitVectorTest, OnePageReadPerQuery) {
+  ExternalBitVector::Write(path_, v1_);
+  ExternalBitVector ebv(path_, v1_.size(), 4096, 0);
+  uint64_t n_queries = 0;
+
+  for (uint64_t x = 0; x < v1_.size(); x += 4099, n_queries += 3) {
+    ebv.At(x);
+    ebv.Rank(x);
+    ebv.Select(ebv.Rank(x) / 2);
+  }
+
+  // Rank(x) is also called as an argument.
+  n_queries += n_queries / 3;
+  EXPECT_EQ(n_queries, ebv.hits() + ebv.misses());
+  EXPECT_GT(ebv.misses(), 0u);
+
+  // the cache keeps at least one page.
+  ebv.ResetCounters();
+  ebv.At(0);
+  ebv.At(1);
+  EXPECT_EQ(1u, ebv.hits());
+  EXPECT_EQ(1u, ebv.misses());
+}
+
+TEST_F(ExternalBitVectorTest, EmptyWorks) {
+  std::vector<bool> v(100, false);
+  ExternalBitVector::Write(path_, v);
+  ExternalBitVector ebv(path_, v.size());
+
+  EXPECT_EQ(0u, ebv.Rank(99));
+  EXPECT_EQ(BitVector(v).Select(0), ebv.Select(0));
+  EXPECT_THROW(ExternalBitVector(path_, v.size(), 100), std::runtime_error);
+  EXPECT_THROW(ExternalBitVector(path_ + ".missing", v.size()), std::runtime_error);
+}
+
+} // namespace succinct_bv
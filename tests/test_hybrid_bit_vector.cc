@@ -0,0 +1,106 @@
+#include "hybrid_bit_vector.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "bit_vector.h"
+#include "naive_bit_vector.h"
+
+namespace succinct_bv {
+
+class HybridBitVectorTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    v1_.resize(8, false);
+    v1_[0] = true;
+    v1_[2] = true;
+    v1_[3] = true;
+    v1_[7] = true; // 10110001
+
+    // dense, sparse and long runs of ones or zeros every 1 << 16 bits.
+    v2_.resize(1500000, false);
+
+    for (size_t i = 0; i < v2_.size(); ++i) {
+      switch ((i >> 16) % 4) {
+        case 0: v2_[i] = rand() % 2 == 0; break;
+        case 1: v2_[i] = rand() % 1000 == 0; break;
+        case 2: v2_[i] = (i / 5000) % 2 == 0; break;
+        default: v2_[i] = (i >> 16) % 8 == 3;
+      }
+    }
+  }
+
+  std::vector<bool> v1_;
+  std::vector<bool> v2_;
+};
+
+TEST_F(HybridBitVectorTest, SmallWorks) {
+  HybridBitVector bv1(v1_);
+
+  EXPECT_EQ(8u, bv1.size());
+  EXPECT_EQ(true, bv1.At(0));
+  EXPECT_EQ(false, bv1.At(1));
+  EXPECT_EQ(3u, bv1.Rank(6));
+  EXPECT_EQ(4u, bv1.Rank(7));
+  EXPECT_EQ(3u, bv1.Select(2));
+  EXPECT_EQ(7u, bv1.Select(3));
+
+  HybridBitVector bv2(std::deque<bool>{false, false});
+  EXPECT_EQ(0u, bv2.Rank(1));
+  EXPECT_EQ(BitVector(std::vector<bool>{false, false}).Select(0), bv2.Select(0));
+
+  EXPECT_THROW(HybridBitVector(std::vector<bool>()), std::runtime_error);
+  EXPECT_THROW(HybridBitVector().Rank(0), std::runtime_error);
+}
+
+TEST_F(HybridBitVectorTest, UsesEveryContainer) {
+  HybridBitVector bv(v2_);
+
+  EXPECT_GT(bv.n_arrays(), 0u);
+  EXPECT_GT(bv.n_bitmaps(), 0u);
+  EXPECT_GT(bv.n_runs(), 0u);
+  EXPECT_LT(bv.n_bytes(), BitVector(v2_).n_bytes());
+
+  // every container is allocated at its exact size.
+  const uint64_t chunk_bits = HybridBitVector::kChunkBits;
+  const size_t bitmap_bytes = chunk_bits / 8 + chunk_bits / 512 * sizeof(uint16_t);
+  uint64_t n_chunks = (v2_.size() - 1) / chunk_bits + 1;
+  size_t values_bytes = 0;
+
+  for (uint64_t start = 0; start < v2_.size(); start += chunk_bits) {
+    size_t n_ones = 0;
+    size_t n_runs = 0;
+
+    for (uint64_t x = start; x < std::min<uint64_t>(v2_.size(), start + chunk_bits); ++x) {
+      if (v2_[x]) ++n_ones;
+      if (v2_[x] && (x == start || !v2_[x - 1])) ++n_runs;
+    }
+
+    size_t array_bytes = n_ones * sizeof(uint16_t);
+    size_t run_bytes = n_runs * 3 * sizeof(uint16_t);
+
+    if (std::min(array_bytes, run_bytes) <= bitmap_bytes)
+      values_bytes += std::min(array_bytes, run_bytes);
+  }
+
+  // a chunk descriptor is an offset, a size and a type, padded to 16 bytes.
+  EXPECT_EQ(n_chunks * 16 + (n_chunks + 1) * sizeof(uint64_t) + values_bytes
+            + bv.n_bitmaps() * bitmap_bytes, bv.n_bytes());
+}
+
+TEST_F(HybridBitVectorTest, QueriesWork) {
+  HybridBitVector bv(v2_);
+  NaiveBitVector nbv(v2_);
+
+  for (uint64_t x = 0; x < v2_.size(); ++x) {
+    EXPECT_EQ(v2_[x], bv.At(x));
+    EXPECT_EQ(nbv.Rank(x), bv.Rank(x));
+  }
+
+  for (uint64_t i = 0, n = nbv.Rank(v2_.size() - 1); i < n; ++i)
+    EXPECT_EQ(nbv.Select(i), bv.Select(i));
+}
+
+} // namespace succinct_bv
@@ -0,0 +1,169 @@
+#include "bit_vector.h"
+
+#include <bitset>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "bit_vector_builder.h"
+
+namespace succinct_bv {
+
+// more than 2^32 bits, and more than 2^32 ones, with a partial last word.
+const uint64_t kN = (uint64_t(5) << 30) + 17;
+// 2^25 zero bits around bit 2^32 make a select block sparse enough for SelectIndexArray.
+const uint64_t kGapFirstWord = ((uint64_t(1) << 32) - (uint64_t(1) << 24)) / 32;
+const uint64_t kGapWords = (uint64_t(1) << 25) / 32;
+// about one word in kCheckRate is checked against the oracle.
+const uint64_t kCheckRate = 64;
+
+static uint64_t Hash(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// segments of 2^21 bits are mostly all ones, one in 16 is random and one in 16 is sparse,
+// so that every kind of select index is built.
+static uint32_t Word(uint64_t k) {
+  if (k >= kGapFirstWord && k < kGapFirstWord + kGapWords) return 0;
+
+  uint64_t h = Hash(k);
+
+  switch ((k >> 16) % 16) {
+    case 14: return static_cast<uint32_t>(h);
+    case 15: return h % 64 == 0 ? 1u << (h >> 32) % 32 : 0;
+    default: return 0xffffffffu;
+  }
+}
+
+// the bits of the word that are in the bit vector.
+static uint32_t StoredWord(uint64_t k) {
+  if (k < kN / 32) return Word(k);
+  return Word(k) & ~(0xffffffffu >> (kN % 32));
+}
+
+static bool NearBoundary(uint64_t first, uint64_t last) {
+  const uint64_t boundary = uint64_t(1) << 32;
+  return first <= boundary + 64 && last + 64 >= boundary;
+}
+
+class LargeBitVectorTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    auto start = std::chrono::steady_clock::now();
+    BitVectorBuilder builder(kN);
+    std::vector<uint32_t> words(BitVectorBuilder::kChunkWords);
+
+    for (uint64_t k = 0; k < kN / 32; k += words.size()) {
+      size_t n_words = std::min<uint64_t>(words.size(), kN / 32 - k);
+
+      for (size_t j = 0; j < n_words; ++j)
+        words[j] = Word(k + j);
+
+      builder.Append(words.data(), n_words);
+    }
+
+    for (uint64_t x = kN / 32 * 32; x < kN; ++x)
+      builder.PushBack(Word(kN / 32) & (1u << (31 - x % 32)));
+
+    bv_ = new BitVector(builder.Build());
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "built " << kN << " bits in " << s << " s (" << kN / s / 1e6 << " Mbit/s), "
+              << 8.0 * bv_->n_bytes() / kN << " bits/bit" << std::endl;
+  }
+
+  static void TearDownTestSuite() {
+    delete bv_;
+    bv_ = nullptr;
+  }
+
+  static BitVector *bv_;
+};
+
+BitVector *LargeBitVectorTest::bv_ = nullptr;
+
+TEST_F(LargeBitVectorTest, MatchesStreamingOracle) {
+  const BitVector &bv = *bv_;
+  ASSERT_EQ(kN, bv.size());
+
+  // ones before the current word.
+  uint64_t rank = 0;
+  uint64_t n_checks = 0;
+
+  for (uint64_t k = 0; k <= kN / 32; ++k) {
+    uint32_t word = StoredWord(k);
+    uint64_t count = std::bitset<32>(word).count();
+    uint64_t h = Hash(k ^ 0x5bd1e995);
+    bool check = h % kCheckRate == 0 || NearBoundary(32 * k, 32 * k + 31);
+
+    if (check) {
+      for (uint64_t y = 0; y < 32 && 32 * k + y < kN; ++y) {
+        if (y != (h >> 32) % 32 && !NearBoundary(32 * k + y, 32 * k + y)) continue;
+
+        uint64_t x = 32 * k + y;
+        uint64_t expected = rank + std::bitset<32>(word >> (31 - y)).count();
+        ASSERT_EQ((word >> (31 - y)) & 1, bv.At(x)) << x;
+        ASSERT_EQ(expected, bv.Rank(x)) << x;
+        ++n_checks;
+      }
+    }
+
+    if (count > 0 && (check || NearBoundary(rank, rank + count - 1))) {
+      uint64_t i = rank;
+
+      for (uint64_t y = 0; y < 32; ++y) {
+        if (((word >> (31 - y)) & 1) == 0) continue;
+
+        if (i == rank + (h >> 40) % count || NearBoundary(i, i)) {
+          ASSERT_EQ(32 * k + y, bv.Select(i)) << i;
+          ++n_checks;
+        }
+
+        ++i;
+      }
+    }
+
+    rank += count;
+  }
+
+  EXPECT_GT(rank, uint64_t(1) << 32);
+  EXPECT_EQ(rank, bv.Rank(kN - 1));
+  std::cout << rank << " ones, " << n_checks << " queries checked" << std::endl;
+}
+
+TEST_F(LargeBitVectorTest, Throughput) {
+  const BitVector &bv = *bv_;
+  uint64_t n_ones = bv.Rank(kN - 1);
+  std::mt19937_64 rng(0);
+  std::vector<uint64_t> positions(1 << 22);
+  std::vector<uint64_t> ranks(1 << 22);
+
+  for (size_t k = 0; k < positions.size(); ++k) {
+    positions[k] = rng() % kN;
+    ranks[k] = rng() % n_ones;
+  }
+
+  uint64_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+
+  for (auto x : positions)
+    sum += bv.Rank(x);
+
+  auto middle = std::chrono::steady_clock::now();
+
+  for (auto i : ranks)
+    sum += bv.Select(i);
+
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "Rank " << std::chrono::duration<double, std::nano>(middle - start).count() / positions.size()
+            << " ns/query, Select " << std::chrono::duration<double, std::nano>(end - middle).count() / ranks.size()
+            << " ns/query" << std::endl;
+  EXPECT_NE(0u, sum);
+}
+
+} // namespace succinct_bv
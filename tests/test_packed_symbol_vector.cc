@@ -0,0 +1,92 @@
+#include "packed_symbol_vector.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace succinct_bv {
+
+class PackedSymbolVectorTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    v1_ = {0, 2, 3, 1, 1, 0, 3}; // ACTGGAT
+
+    // crosses several superblocks of both widths, with a skewed distribution every 1 << 16 symbols.
+    v2_.resize(1500000);
+
+    for (size_t i = 0; i < v2_.size(); ++i)
+      v2_[i] = (i >> 16) % 2 == 0 ? rand() % 16 : (rand() % 8 == 0 ? rand() % 16 : 5);
+  }
+
+  template<int kBits>
+  void CheckAll(const std::vector<uint8_t> &v) {
+    PackedSymbolVector<kBits> sv(v);
+    const uint64_t sigma = PackedSymbolVector<kBits>::kSigma;
+    std::vector<uint64_t> counts(sigma, 0);
+
+    EXPECT_EQ(v.size(), sv.size());
+
+    for (size_t i = 0; i < v.size(); ++i) {
+      uint8_t c = v[i] % sigma;
+      ++counts[c];
+      ASSERT_EQ(c, sv.At(i));
+
+      if (i % 7 == 0) {
+        for (uint64_t d = 0; d < sigma; ++d)
+          ASSERT_EQ(counts[d], sv.Rank(d, i));
+      }
+
+      if (i % 11 == 0) {
+        auto ranks = sv.RankAll(i);
+
+        for (uint64_t d = 0; d < sigma; ++d)
+          ASSERT_EQ(counts[d], ranks[d]);
+      }
+    }
+  }
+
+  std::vector<uint8_t> v1_;
+  std::vector<uint8_t> v2_;
+};
+
+TEST_F(PackedSymbolVectorTest, SmallWorks) {
+  PackedSymbolVector<2> sv(v1_);
+
+  EXPECT_EQ(3, sv.At(2));
+  EXPECT_EQ(1, sv.Rank(0, 0));
+  EXPECT_EQ(1, sv.Rank(0, 4));
+  EXPECT_EQ(2, sv.Rank(0, 5));
+  EXPECT_EQ(2, sv.Rank(1, 6));
+  EXPECT_EQ(0, sv.Rank(1, 2));
+
+  auto ranks = sv.RankAll(6);
+  EXPECT_EQ(2, ranks[0]);
+  EXPECT_EQ(2, ranks[1]);
+  EXPECT_EQ(1, ranks[2]);
+  EXPECT_EQ(2, ranks[3]);
+}
+
+TEST_F(PackedSymbolVectorTest, TwoBitsWorks) {
+  CheckAll<2>(v2_);
+}
+
+TEST_F(PackedSymbolVectorTest, FourBitsWorks) {
+  CheckAll<4>(v2_);
+}
+
+TEST_F(PackedSymbolVectorTest, EmptyThrows) {
+  EXPECT_THROW(PackedSymbolVector<2>(std::vector<uint8_t>()), std::runtime_error);
+  PackedSymbolVector<4> sv;
+  EXPECT_THROW(sv.Rank(0, 0), std::runtime_error);
+}
+
+TEST_F(PackedSymbolVectorTest, InvalidSymbolThrows) {
+  PackedSymbolVector<2> sv2(v1_);
+  EXPECT_THROW(sv2.Rank(4, 0), std::runtime_error);
+
+  PackedSymbolVector<4> sv4(v1_);
+  EXPECT_EQ(0u, sv4.Rank(15, 6));
+  EXPECT_THROW(sv4.Rank(16, 0), std::runtime_error);
+}
+
+} // namespace succinct_bv
@@ -0,0 +1,104 @@
+#include "query_executor.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "bit_vector.h"
+
+namespace succinct_bv {
+
+class QueryExecutorTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    v1_.resize(3000000, false);
+    n_true_ = 0;
+
+    for (size_t i = 0; i < v1_.size(); ++i) {
+      int period = (i >> 18) % 2 == 0 ? 2 : 1000;
+
+      if (rand() % period == 0) {
+        v1_[i] = true;
+        ++n_true_;
+      }
+    }
+
+    for (int k = 0; k < 200000; ++k) {
+      QueryExecutor::Query::Type type = static_cast<QueryExecutor::Query::Type>(rand() % 3);
+      uint64_t x = type == QueryExecutor::Query::kSelect ? rand() % n_true_ : rand() % v1_.size();
+      queries_.push_back({type, x});
+    }
+  }
+
+  std::vector<uint64_t> Expected(const BitVector &bv) {
+    std::vector<uint64_t> answers;
+
+    for (auto &q : queries_) {
+      switch (q.type) {
+        case QueryExecutor::Query::kAt: answers.push_back(bv.At(q.x)); break;
+        case QueryExecutor::Query::kRank: answers.push_back(bv.Rank(q.x)); break;
+        default: answers.push_back(bv.Select(q.x));
+      }
+    }
+
+    return answers;
+  }
+
+  uint64_t n_true_;
+  std::vector<bool> v1_;
+  std::vector<QueryExecutor::Query> queries_;
+};
+
+TEST_F(QueryExecutorTest, AnswersInInputOrder) {
+  BitVector bv(v1_);
+  std::vector<uint64_t> expected = Expected(bv);
+
+  for (size_t n_threads : {1, 2, 5}) {
+    QueryExecutor executor(n_threads);
+    EXPECT_EQ(n_threads, executor.n_threads());
+
+    // the pool is reused across batches.
+    for (int k = 0; k < 3; ++k)
+      EXPECT_EQ(expected, executor.Execute(bv, queries_));
+  }
+}
+
+TEST_F(QueryExecutorTest, ConcurrentCallersWork) {
+  BitVector bv(v1_);
+  std::vector<QueryExecutor::Query> queries(queries_.begin(), queries_.begin() + 5000);
+  std::vector<uint64_t> expected = Expected(bv);
+  expected.resize(queries.size());
+  QueryExecutor executor(4);
+  std::vector<std::thread> threads;
+  std::vector<int> n_wrong(4, 0);
+
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int k = 0; k < 100; ++k)
+        if (executor.Execute(bv, queries) != expected) ++n_wrong[t];
+    });
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  for (int t = 0; t < 4; ++t)
+    EXPECT_EQ(0, n_wrong[t]);
+}
+
+TEST_F(QueryExecutorTest, SmallBatchesWork) {
+  BitVector bv(v1_);
+  QueryExecutor executor(3);
+
+  EXPECT_TRUE(executor.Execute(bv, {}).empty());
+
+  std::vector<QueryExecutor::Query> queries = {{QueryExecutor::Query::kSelect, 0},
+                                               {QueryExecutor::Query::kRank, 0}};
+  std::vector<uint64_t> expected = {bv.Select(0), bv.Rank(0)};
+  EXPECT_EQ(expected, executor.Execute(bv, queries));
+
+  EXPECT_THROW(executor.Execute(BitVector(), queries), std::runtime_error);
+}
+
+} // namespace succinct_bv
@@ -0,0 +1,108 @@
+#include "run_length_bit_vector.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "bit_vector.h"
+#include "naive_bit_vector.h"
+
+namespace succinct_bv {
+
+class RunLengthBitVectorTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    v1_.resize(8, false);
+    v1_[0] = true;
+    v1_[2] = true;
+    v1_[3] = true;
+    v1_[7] = true; // 10110001
+
+    // long runs of random length, with a few short ones.
+    v2_.resize(1000000, false);
+    bool bit = false;
+
+    for (size_t i = 0; i < v2_.size();) {
+      size_t length = rand() % 10 == 0 ? 1 + rand() % 3 : 1 + rand() % 50000;
+
+      for (size_t end = std::min(v2_.size(), i + length); i < end; ++i)
+        v2_[i] = bit;
+
+      bit = !bit;
+    }
+  }
+
+  std::vector<bool> v1_;
+  std::vector<bool> v2_;
+};
+
+TEST_F(RunLengthBitVectorTest, SmallWorks) {
+  RunLengthBitVector bv1(v1_);
+
+  EXPECT_EQ(3u, bv1.n_runs());
+  EXPECT_EQ(true, bv1.At(0));
+  EXPECT_EQ(false, bv1.At(1));
+  EXPECT_EQ(true, bv1.At(3));
+  EXPECT_EQ(1u, bv1.Rank(1));
+  EXPECT_EQ(3u, bv1.Rank(6));
+  EXPECT_EQ(4u, bv1.Rank(7));
+  EXPECT_EQ(2u, bv1.Select(1));
+  EXPECT_EQ(7u, bv1.Select(3));
+  EXPECT_EQ(1u, bv1.Select0(0));
+  EXPECT_EQ(4u, bv1.Select0(1));
+  EXPECT_EQ(6u, bv1.Select0(3));
+
+  std::deque<bool> d = {false, false};
+  RunLengthBitVector bv2(d);
+  EXPECT_EQ(0u, bv2.Rank(1));
+  EXPECT_EQ(1u, bv2.Select0(1));
+  EXPECT_EQ(BitVector(d).Select(0), bv2.Select(0));
+
+  EXPECT_THROW(RunLengthBitVector(std::vector<bool>()), std::runtime_error);
+  EXPECT_THROW(RunLengthBitVector().Rank(0), std::runtime_error);
+}
+
+TEST_F(RunLengthBitVectorTest, QueriesWork) {
+  RunLengthBitVector bv(v2_);
+  std::vector<bool> inverted(v2_.size());
+
+  for (size_t i = 0; i < v2_.size(); ++i)
+    inverted[i] = !v2_[i];
+
+  NaiveBitVector nbv(v2_);
+  NaiveBitVector zeros(inverted);
+
+  for (uint64_t x = 0; x < v2_.size(); ++x) {
+    EXPECT_EQ(v2_[x], bv.At(x));
+    EXPECT_EQ(nbv.Rank(x), bv.Rank(x));
+  }
+
+  for (uint64_t i = 0, n = nbv.Rank(v2_.size() - 1); i < n; ++i)
+    EXPECT_EQ(nbv.Select(i), bv.Select(i));
+
+  for (uint64_t i = 0, n = zeros.Rank(v2_.size() - 1); i < n; ++i)
+    EXPECT_EQ(zeros.Select(i), bv.Select0(i));
+
+  EXPECT_LT(bv.n_bytes(), 16 * bv.n_runs() + 64);
+}
+
+TEST_F(RunLengthBitVectorTest, ConversionIsLossless) {
+  for (auto &v : {v1_, v2_, std::vector<bool>(100, true), std::vector<bool>(33, false)}) {
+    BitVector bv(v);
+    RunLengthBitVector from_bits(v);
+    RunLengthBitVector from_bv(bv);
+    BitVector back = from_bv.ToBitVector();
+
+    ASSERT_EQ(v.size(), from_bv.size());
+    EXPECT_EQ(from_bits.n_runs(), from_bv.n_runs());
+    ASSERT_EQ(v.size(), back.size());
+
+    for (uint64_t x = 0; x < v.size(); ++x) {
+      EXPECT_EQ(v[x], from_bv.At(x));
+      EXPECT_EQ(bv.Rank(x), back.Rank(x));
+    }
+  }
+}
+
+} // namespace succinct_bv